@@ -4,6 +4,7 @@
 #include <time.h>
 #include "usr/crypto.h"
 #include "usr/encoding.h"
+#include "usr/rand.h"
 
 #define MB (1024*1024)
 
@@ -30,6 +31,155 @@ static void bench_sha256(size_t data_size, int iters) {
     free(data);
 }
 
+static void bench_sha1(size_t data_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(data_size);
+    uint8_t  out[20];
+    memset(data, 0xAB, data_size);
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        usr_sha1(data, data_size, out);
+    }
+    double elapsed = now_ms() - t0;
+    double mbps = (data_size * iters / MB) / (elapsed / 1000.0);
+
+    printf("SHA-1    %4zuKB x %5d = %7.2f ms  |  %.1f MB/s\n",
+           data_size/1024, iters, elapsed, mbps);
+    free(data);
+}
+
+static void bench_sha256_many(size_t msg_size, size_t n_msgs, int iters) {
+    uint8_t *data = (uint8_t*)malloc(msg_size * n_msgs);
+    uint8_t *out  = (uint8_t*)malloc(32 * n_msgs);
+    usr_sha256_job *jobs = (usr_sha256_job*)malloc(sizeof(*jobs) * n_msgs);
+    memset(data, 0xAB, msg_size * n_msgs);
+    for (size_t j = 0; j < n_msgs; j++) {
+        jobs[j].data = data + msg_size * j;
+        jobs[j].len  = msg_size;
+        jobs[j].out  = out + 32 * j;
+    }
+    double total = (double)n_msgs * iters / 1e6;
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        for (size_t j = 0; j < n_msgs; j++) usr_sha256(jobs[j].data, msg_size, jobs[j].out);
+    }
+    double serial = now_ms() - t0;
+
+    t0 = now_ms();
+    for (int i = 0; i < iters; i++) usr_sha256_many(jobs, n_msgs);
+    double batched = now_ms() - t0;
+
+    printf("SHA-256 x%zu  %4zuB msgs  serial %.2f M/s  |  batched %.2f M/s\n",
+           n_msgs, msg_size, total / (serial / 1000.0), total / (batched / 1000.0));
+    free(data); free(out); free(jobs);
+}
+
+static void bench_hmac(size_t msg_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(msg_size);
+    uint8_t  key[32], out[32];
+    memset(data, 0xAB, msg_size);
+    memset(key,  0x11, 32);
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) usr_hmac_sha256(key, 32, data, msg_size, out);
+    double oneshot = now_ms() - t0;
+
+    usr_hmac_sha256_key hk;
+    usr_hmac_sha256_key_init(&hk, key, 32);
+    t0 = now_ms();
+    for (int i = 0; i < iters; i++) usr_hmac_sha256_keyed(&hk, data, msg_size, out);
+    double keyed = now_ms() - t0;
+    usr_hmac_sha256_key_wipe(&hk);
+
+    printf("HMAC     %4zuB msgs  one-shot %.1f ns/MAC  |  prepared key %.1f ns/MAC\n",
+           msg_size, oneshot * 1e6 / iters, keyed * 1e6 / iters);
+    free(data);
+}
+
+static void bench_pbkdf2(uint32_t iterations, size_t out_len) {
+    uint8_t *out = (uint8_t*)malloc(out_len);
+
+    double t0 = now_ms();
+    usr_pbkdf2_sha256((const uint8_t*)"password", 8, (const uint8_t*)"salt", 4,
+                      iterations, out, out_len);
+    double elapsed = now_ms() - t0;
+
+    printf("PBKDF2   c=%u  %3zuB out = %7.2f ms  |  %.1f ns/iteration\n",
+           iterations, out_len, elapsed, elapsed * 1e6 / iterations / ((out_len + 31) / 32));
+    free(out);
+}
+
+static void bench_pbkdf2_sha512(uint32_t iterations) {
+    uint8_t out[64];
+
+    double t0 = now_ms();
+    usr_pbkdf2_sha512((const uint8_t*)"password", 8, (const uint8_t*)"salt", 4,
+                      iterations, out, sizeof(out));
+    double elapsed = now_ms() - t0;
+
+    printf("PBKDF2-SHA512  c=%u  64B out = %7.2f ms  |  %.1f ns/iteration\n",
+           iterations, elapsed, elapsed * 1e6 / iterations);
+}
+
+static void bench_pbkdf2_many(int sha512, size_t n, uint32_t iterations) {
+    size_t hlen = sha512 ? 64 : 32;
+    uint8_t *out = (uint8_t*)malloc(n * hlen);
+    usr_pbkdf2_job *jobs = (usr_pbkdf2_job*)malloc(n * sizeof(*jobs));
+    for (size_t i = 0; i < n; i++) {
+        jobs[i].password     = (const uint8_t*)"correct horse battery staple";
+        jobs[i].password_len = 28;
+        jobs[i].salt         = (const uint8_t*)"per-user-salt-16";
+        jobs[i].salt_len     = 16;
+        jobs[i].iterations   = iterations;
+        jobs[i].out          = out + i * hlen;
+        jobs[i].out_len      = hlen;
+    }
+
+    double t0 = now_ms();
+    for (size_t i = 0; i < n; i++) {
+        if (sha512) usr_pbkdf2_sha512(jobs[i].password, 28, jobs[i].salt, 16, iterations, jobs[i].out, hlen);
+        else        usr_pbkdf2_sha256(jobs[i].password, 28, jobs[i].salt, 16, iterations, jobs[i].out, hlen);
+    }
+    double serial = now_ms() - t0;
+
+    t0 = now_ms();
+    if (sha512) usr_pbkdf2_sha512_many(jobs, n);
+    else        usr_pbkdf2_sha256_many(jobs, n);
+    double batched = now_ms() - t0;
+
+    printf("PBKDF2-SHA%d x%zu  c=%u  serial %.1f keys/s  |  batched %.1f keys/s\n",
+           sha512 ? 512 : 256, n, iterations, n / (serial / 1000.0), n / (batched / 1000.0));
+    free(out); free(jobs);
+}
+
+static void bench_sha512(size_t data_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(data_size);
+    uint8_t  out[64];
+    memset(data, 0xAB, data_size);
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        usr_sha512(data, data_size, out);
+    }
+    double elapsed = now_ms() - t0;
+    double mbps = (data_size * iters / MB) / (elapsed / 1000.0);
+
+    printf("SHA-512  %4zuKB x %5d = %7.2f ms  |  %.1f MB/s\n",
+           data_size/1024, iters, elapsed, mbps);
+    free(data);
+}
+
+static const char *aes_impl_name(void) {
+    switch (usr_aes_get_impl()) {
+        case USR_AES_IMPL_BYTE:   return "byte";
+        case USR_AES_IMPL_TTABLE: return "ttable";
+        case USR_AES_IMPL_AESNI:  return "aesni";
+        case USR_AES_IMPL_BITSLICE: return "bitslice";
+        default:                 return "auto";
+    }
+}
+
 static void bench_aes_ige(size_t data_size, int iters) {
     uint8_t *data = (uint8_t*)malloc(data_size);
     uint8_t  key[32], iv[32];
@@ -47,44 +197,318 @@ static void bench_aes_ige(size_t data_size, int iters) {
     double elapsed = now_ms() - t0;
     double mbps = (data_size * iters / MB) / (elapsed / 1000.0);
 
-    printf("AES-IGE  %4zuKB x %5d = %7.2f ms  |  %.1f MB/s\n",
-           data_size/1024, iters, elapsed, mbps);
+    printf("AES-IGE  %4zuKB x %5d = %7.2f ms  |  %.1f MB/s  [%s]\n",
+           data_size/1024, iters, elapsed, mbps, aes_impl_name());
     free(data);
 }
 
-static void bench_base64(size_t data_size, int iters) {
+/* Many small messages under different keys, one at a time vs batched */
+static void bench_aes_ige_many(size_t msg_size, size_t n_msgs, int iters) {
+    uint8_t *data = (uint8_t*)malloc(msg_size * n_msgs);
+    uint8_t *keys = (uint8_t*)malloc(32 * n_msgs);
+    uint8_t  iv[32];
+    usr_aes256_ige_job *jobs = (usr_aes256_ige_job*)malloc(sizeof(*jobs) * n_msgs);
+    memset(data, 0, msg_size * n_msgs);
+    memset(iv, 0x22, 32);
+    for (size_t j = 0; j < n_msgs; j++) {
+        memset(keys + 32 * j, (int)j, 32);
+        jobs[j].data = data + msg_size * j;
+        jobs[j].len  = msg_size;
+        jobs[j].key  = keys + 32 * j;
+        jobs[j].iv   = iv;
+    }
+    double total = (double)(msg_size * n_msgs) * iters / MB;
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        for (size_t j = 0; j < n_msgs; j++) {
+            usr_aes256_ige_encrypt(jobs[j].data, msg_size, jobs[j].key, iv);
+        }
+    }
+    double serial = now_ms() - t0;
+
+    t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        usr_aes256_ige_encrypt_many(jobs, n_msgs);
+    }
+    double batched = now_ms() - t0;
+
+    printf("IGE x%zu  %4zuB msgs  serial %.1f MB/s  |  batched %.1f MB/s  [%s]\n",
+           n_msgs, msg_size, total / (serial / 1000.0), total / (batched / 1000.0),
+           aes_impl_name());
+    free(data); free(keys); free(jobs);
+}
+
+static void bench_aes_ctr(size_t data_size, int iters) {
     uint8_t *data = (uint8_t*)malloc(data_size);
-    char    *enc  = (char*)malloc(data_size * 2);
-    memset(data, 0xCD, data_size);
+    uint8_t  key[32], nonce[16];
+    memset(data, 0, data_size);
+    memset(key,  0x11, 32);
+    memset(nonce, 0, 16);
 
     double t0 = now_ms();
     for (int i = 0; i < iters; i++) {
-        usr_base64_encode(data, data_size, enc);
+        usr_aes256_ctr_crypt(data, data_size, key, nonce);
     }
     double elapsed = now_ms() - t0;
     double mbps = (data_size * iters / MB) / (elapsed / 1000.0);
 
-    printf("Base64   %4zuKB x %5d = %7.2f ms  |  %.1f MB/s\n",
-           data_size/1024, iters, elapsed, mbps);
+    printf("AES-CTR  %4zuKB x %5d = %7.2f ms  |  %.1f MB/s  [%s]\n",
+           data_size/1024, iters, elapsed, mbps, aes_impl_name());
+    free(data);
+}
+
+static void bench_aes_gcm(size_t data_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(data_size);
+    uint8_t  key[32], iv[12], tag[16];
+    memset(data, 0, data_size);
+    memset(key,  0x11, 32);
+    memset(iv,   0x22, 12);
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        usr_aes256_gcm_encrypt(key, iv, 12, NULL, 0, data, data_size, data, tag);
+    }
+    double elapsed = now_ms() - t0;
+    double mbps = (data_size * iters / MB) / (elapsed / 1000.0);
+
+    printf("AES-GCM  %4zuKB x %5d = %7.2f ms  |  %.1f MB/s  [%s]\n",
+           data_size/1024, iters, elapsed, mbps, aes_impl_name());
+    free(data);
+}
+
+static void bench_aes_cbc_decrypt(size_t data_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(data_size + 16);
+    uint8_t *enc  = (uint8_t*)malloc(data_size + 16);
+    uint8_t  key[32], iv[16];
+    size_t   enc_len = data_size + 16;
+    memset(data, 0, data_size);
+    memset(key,  0x11, 32);
+    memset(iv,   0x22, 16);
+    usr_aes256_cbc_encrypt(data, data_size, key, iv, enc, &enc_len);
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        size_t out_len = enc_len;
+        usr_aes256_cbc_decrypt(enc, enc_len, key, iv, data, &out_len);
+    }
+    double elapsed = now_ms() - t0;
+    double mbps = (data_size * iters / MB) / (elapsed / 1000.0);
+
+    printf("CBC-dec  %4zuKB x %5d = %7.2f ms  |  %.1f MB/s  [%s]\n",
+           data_size/1024, iters, elapsed, mbps, aes_impl_name());
     free(data); free(enc);
 }
 
+static void bench_crc32(size_t data_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(data_size);
+    memset(data, 0xAB, data_size);
+    volatile uint32_t sink = 0;
+
+    static const uint32_t masks[3] = { 0, USR_CPU_VPCLMUL, USR_CPU_PCLMUL };
+    double ms[3];
+    for (int m = 0; m < 3; m++) {
+        usr_cpu_disable(masks[m]);
+        double t0 = now_ms();
+        for (int i = 0; i < iters; i++) sink ^= usr_crc32(data, data_size);
+        ms[m] = now_ms() - t0;
+    }
+    usr_cpu_disable(0);
+
+    double mb = data_size * (double)iters / MB;
+    printf("CRC-32   %4zuKB x %5d  best %.1f MB/s  |  PCLMUL %.1f MB/s  |  slicing-by-16 %.1f MB/s\n",
+           data_size/1024, iters, mb / (ms[0] / 1000.0), mb / (ms[1] / 1000.0), mb / (ms[2] / 1000.0));
+    (void)sink;
+    free(data);
+}
+
+static void bench_crc32c(size_t data_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(data_size);
+    memset(data, 0xAB, data_size);
+    volatile uint32_t sink = 0;
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) sink ^= usr_crc32c(data, data_size);
+    double fast = now_ms() - t0;
+
+    usr_cpu_disable(USR_CPU_SSE42);
+    t0 = now_ms();
+    for (int i = 0; i < iters; i++) sink ^= usr_crc32c(data, data_size);
+    double table = now_ms() - t0;
+    usr_cpu_disable(0);
+
+    double mb = data_size * (double)iters / MB;
+    printf("CRC-32C  %4zuKB x %5d  SSE4.2 %.1f MB/s  |  slicing-by-8 %.1f MB/s\n",
+           data_size/1024, iters, mb / (fast / 1000.0), mb / (table / 1000.0));
+    (void)sink;
+    free(data);
+}
+
+/* Large buffer: one thread against the default thread count. Run
+   under the slicing-by-16 path too, where threads matter most. */
+static void bench_crc32_threads(size_t data_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(data_size);
+    memset(data, 0xAB, data_size);
+    volatile uint32_t sink = 0;
+
+    static const uint32_t masks[2] = { 0, USR_CPU_PCLMUL };
+    static const char *names[2] = { "best", "slicing-by-16" };
+    for (int m = 0; m < 2; m++) {
+        double ms[2];
+        usr_cpu_disable(masks[m]);
+        for (int t = 0; t < 2; t++) {
+            usr_crypto_set_threads(t == 0 ? 1 : 0);
+            double t0 = now_ms();
+            for (int i = 0; i < iters; i++) sink ^= usr_crc32(data, data_size);
+            ms[t] = now_ms() - t0;
+        }
+        usr_crypto_set_threads(0);
+        usr_cpu_disable(0);
+
+        double mb = data_size * (double)iters / MB;
+        printf("CRC-32   %4zuMB x %5d  %-13s 1 thread %.1f MB/s  |  all threads %.1f MB/s\n",
+               data_size/(1024*1024), iters, names[m], mb / (ms[0] / 1000.0), mb / (ms[1] / 1000.0));
+    }
+    (void)sink;
+    free(data);
+}
+
+static void bench_base64(size_t data_size, int iters) {
+    uint8_t *data = (uint8_t*)malloc(data_size);
+    char    *enc  = (char*)malloc(usr_base64_enc_size(data_size));
+    uint8_t *dec  = (uint8_t*)malloc(usr_base64_dec_size(data_size * 2));
+    for (size_t i = 0; i < data_size; i++) data[i] = (uint8_t)(i * 167 + 13);
+    size_t enc_len = usr_base64_encode(data, data_size, enc);
+
+    /* SIMD (best available) against the scalar loops */
+    static const uint32_t masks[2] = { 0, USR_CPU_SSSE3 };
+    double enc_ms[2], dec_ms[2];
+    for (int m = 0; m < 2; m++) {
+        usr_cpu_disable(masks[m]);
+        double t0 = now_ms();
+        for (int i = 0; i < iters; i++) usr_base64_encode(data, data_size, enc);
+        enc_ms[m] = now_ms() - t0;
+        t0 = now_ms();
+        for (int i = 0; i < iters; i++) usr_base64_decode(enc, enc_len, dec);
+        dec_ms[m] = now_ms() - t0;
+    }
+    usr_cpu_disable(0);
+
+    double mb = data_size * (double)iters / MB;
+    printf("Base64   %4zuKB x %5d  encode %.1f MB/s (scalar %.1f)  |  decode %.1f MB/s (scalar %.1f)\n",
+           data_size/1024, iters, mb / (enc_ms[0] / 1000.0), mb / (enc_ms[1] / 1000.0),
+           mb / (dec_ms[0] / 1000.0), mb / (dec_ms[1] / 1000.0));
+    free(data); free(enc); free(dec);
+}
+
+/* Streaming contexts fed 4 KB chunks, as from a file */
+static void bench_base64_stream(size_t data_size, int iters) {
+    enum { CHUNK = 4096 };
+    uint8_t *data = (uint8_t*)malloc(data_size);
+    char    *enc  = (char*)malloc(usr_base64_enc_size(data_size));
+    uint8_t *dec  = (uint8_t*)malloc(usr_base64_dec_size(data_size * 2));
+    for (size_t i = 0; i < data_size; i++) data[i] = (uint8_t)(i * 167 + 13);
+    size_t enc_len = usr_base64_encode(data, data_size, enc);
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        usr_base64_enc_ctx ec;
+        usr_base64_encode_init(&ec);
+        size_t n = 0;
+        for (size_t pos = 0; pos < data_size; pos += CHUNK) {
+            size_t len = data_size - pos < CHUNK ? data_size - pos : CHUNK;
+            n += usr_base64_encode_update(&ec, data + pos, len, enc + n);
+        }
+        usr_base64_encode_final(&ec, enc + n);
+    }
+    double enc_ms = now_ms() - t0;
+
+    t0 = now_ms();
+    for (int i = 0; i < iters; i++) {
+        usr_base64_dec_ctx dc;
+        usr_base64_decode_init(&dc);
+        size_t n = 0;
+        for (size_t pos = 0; pos < enc_len; pos += CHUNK) {
+            size_t len = enc_len - pos < CHUNK ? enc_len - pos : CHUNK;
+            n += usr_base64_decode_update(&dc, enc + pos, len, dec + n);
+        }
+        usr_base64_decode_final(&dc, dec + n);
+    }
+    double dec_ms = now_ms() - t0;
+
+    double mb = data_size * (double)iters / MB;
+    printf("Base64   %4zuKB x %5d  streaming 4KB chunks: encode %.1f MB/s  |  decode %.1f MB/s\n",
+           data_size/1024, iters, mb / (enc_ms / 1000.0), mb / (dec_ms / 1000.0));
+    free(data); free(enc); free(dec);
+}
+
+static void bench_rand(int iters) {
+    volatile uint32_t sink = 0;
+
+    double t0 = now_ms();
+    for (int i = 0; i < iters; i++) sink ^= usr_rand_u32();
+    double elapsed = now_ms() - t0;
+
+    uint32_t *vals = (uint32_t*)malloc(4096 * sizeof(uint32_t));
+    double t1 = now_ms();
+    for (int i = 0; i < iters / 4096; i++) usr_rand_fill_range_u32(vals, 4096, 1000);
+    double bulk = now_ms() - t1;
+
+    printf("rand_u32 x %d = %7.2f ms (%.1f ns/call)  |  fill_range %.1f ns/value\n",
+           iters, elapsed, elapsed * 1e6 / iters, bulk * 1e6 / (iters / 4096 * 4096));
+    (void)sink;
+    free(vals);
+}
+
 int main(void) {
     printf("====== USR Benchmark ======\n");
     printf("(MB/s = megabytes per second throughput)\n\n");
 
+    bench_sha1(64*1024, 1000);
     bench_sha256(64,    100000);
     bench_sha256(1024,  10000);
     bench_sha256(64*1024, 1000);
+    bench_sha256_many(32,  1024, 200);
+    bench_sha256_many(100, 1024, 200);
+    bench_hmac(64, 200000);
+    bench_pbkdf2(100000, 32);
+    bench_pbkdf2(100000, 128);
+    bench_pbkdf2_sha512(100000);
+    bench_pbkdf2_many(0, 64, 10000);
+    bench_pbkdf2_many(1, 64, 10000);
+    bench_sha512(64,    100000);
+    bench_sha512(1024,  10000);
+    bench_sha512(64*1024, 1000);
 
-    printf("\n");
-    bench_aes_ige(64,      100000);
-    bench_aes_ige(4*1024,  10000);
-    bench_aes_ige(64*1024, 1000);
+    static const usr_aes_impl aes_impls[] = {
+        USR_AES_IMPL_BYTE, USR_AES_IMPL_TTABLE, USR_AES_IMPL_AESNI,
+        USR_AES_IMPL_BITSLICE
+    };
+    for (size_t i = 0; i < sizeof(aes_impls) / sizeof(aes_impls[0]); i++) {
+        if (usr_aes_set_impl(aes_impls[i]) != 0) continue;
+        printf("\n");
+        bench_aes_ige(64,      100000);
+        bench_aes_ige(4*1024,  10000);
+        bench_aes_ige(64*1024, 1000);
+        bench_aes_ige_many(512, 1000, 20);
+        bench_aes_ctr(64*1024, 1000);
+        bench_aes_gcm(64*1024, 1000);
+        bench_aes_cbc_decrypt(4*1024*1024, 10);
+    }
+    usr_aes_set_impl(USR_AES_IMPL_AUTO);
 
     printf("\n");
+    bench_crc32(4*1024,  50000);
+    bench_crc32(1024*1024, 200);
+    bench_crc32_threads(64*1024*1024, 4);
+    bench_crc32c(4*1024,  50000);
+    bench_crc32c(1024*1024, 200);
     bench_base64(1024,   50000);
     bench_base64(64*1024, 2000);
+    bench_base64_stream(1024*1024, 100);
+
+    printf("\n");
+    bench_rand(4000000);
 
     printf("\n====== Done ======\n");
     return 0;
@@ -8,6 +8,63 @@
 extern "C" {
 #endif
 
+/* ============================================================
+   CPU Feature Dispatch
+   Accelerated kernels (AES-NI, ...) are selected at runtime from
+   the features reported here, so one build runs everywhere.
+   ============================================================ */
+
+#define USR_CPU_SSE2      (1u << 0)
+#define USR_CPU_SSSE3     (1u << 1)
+#define USR_CPU_SSE41     (1u << 2)
+#define USR_CPU_SSE42     (1u << 3)
+#define USR_CPU_AESNI     (1u << 4)
+#define USR_CPU_PCLMUL    (1u << 5)
+#define USR_CPU_AVX       (1u << 6)
+#define USR_CPU_AVX2      (1u << 7)
+#define USR_CPU_BMI2      (1u << 8)
+#define USR_CPU_SHA       (1u << 9)
+#define USR_CPU_AVX512F   (1u << 10)
+#define USR_CPU_AVX512BW  (1u << 11)
+#define USR_CPU_AVX512VL  (1u << 12)
+#define USR_CPU_VPCLMUL   (1u << 13)   /* VPCLMULQDQ (256/512-bit carry-less multiply) */
+
+/* Bitmask of USR_CPU_* features detected on this CPU (minus disabled ones). */
+uint32_t usr_cpu_features(void);
+
+/* Hide `mask` features from dispatch (0 re-enables everything).
+   Intended for tests and benchmarks; not thread-safe. */
+void usr_cpu_disable(uint32_t mask);
+
+/* Cap on worker threads used by bulk operations on large inputs
+   (e.g. CBC decryption of multi-megabyte buffers). 0 = one per online
+   CPU (default), 1 = never spawn threads. Not thread-safe. */
+void usr_crypto_set_threads(int n);
+
+/* ============================================================
+   SHA-1
+   Legacy: kept for protocols that mandate it (MTProto auth_key_id,
+   key fingerprints). Do not use for new designs.
+   ============================================================ */
+
+#define USR_SHA1_DIGEST_SIZE 20
+#define USR_SHA1_BLOCK_SIZE  64
+
+typedef struct {
+    uint32_t state[5];
+    uint8_t  buf[64];
+    uint64_t bitcount;
+    uint32_t buflen;
+} usr_sha1_ctx;
+
+/* One-shot SHA-1 */
+void usr_sha1(const uint8_t *data, size_t len, uint8_t out[20]);
+
+/* Streaming SHA-1 */
+void usr_sha1_init(usr_sha1_ctx *ctx);
+void usr_sha1_update(usr_sha1_ctx *ctx, const uint8_t *data, size_t len);
+void usr_sha1_final(usr_sha1_ctx *ctx, uint8_t out[20]);
+
 /* ============================================================
    SHA-256
    ============================================================ */
@@ -30,6 +87,30 @@ void usr_sha256_init(usr_sha256_ctx *ctx);
 void usr_sha256_update(usr_sha256_ctx *ctx, const uint8_t *data, size_t len);
 void usr_sha256_final(usr_sha256_ctx *ctx, uint8_t out[32]);
 
+/* Midstates: hash a shared prefix once, then clone the context per
+   message (a struct copy), or export it to a stable, versioned byte
+   format to cache or send elsewhere. Import rejects malformed or
+   inconsistent input. Both return 0 on success, -1 on error. */
+#define USR_SHA256_EXPORT_SIZE 109
+
+void usr_sha256_clone(usr_sha256_ctx *dst, const usr_sha256_ctx *src);
+int  usr_sha256_export(const usr_sha256_ctx *ctx, uint8_t out[USR_SHA256_EXPORT_SIZE]);
+int  usr_sha256_import(usr_sha256_ctx *ctx, const uint8_t in[USR_SHA256_EXPORT_SIZE]);
+
+/* Hash many independent messages at once. With AVX2 (8 lanes) or
+   AVX-512 (16 lanes) the messages run side by side in SIMD lanes,
+   which is much faster than one usr_sha256() call each for short
+   inputs; lengths may differ freely. Each `out` receives the same
+   digest usr_sha256() would produce. Returns -1 without hashing
+   anything if a job has a NULL `out` (or NULL `data` with len > 0). */
+typedef struct {
+    const uint8_t *data;
+    size_t         len;
+    uint8_t       *out;     /* 32 bytes */
+} usr_sha256_job;
+
+int usr_sha256_many(const usr_sha256_job *jobs, size_t n_jobs);
+
 /* ============================================================
    SHA-512
    ============================================================ */
@@ -53,6 +134,13 @@ void usr_sha512_init(usr_sha512_ctx *ctx);
 void usr_sha512_update(usr_sha512_ctx *ctx, const uint8_t *data, size_t len);
 void usr_sha512_final(usr_sha512_ctx *ctx, uint8_t out[64]);
 
+/* Midstates, as for SHA-256 */
+#define USR_SHA512_EXPORT_SIZE 213
+
+void usr_sha512_clone(usr_sha512_ctx *dst, const usr_sha512_ctx *src);
+int  usr_sha512_export(const usr_sha512_ctx *ctx, uint8_t out[USR_SHA512_EXPORT_SIZE]);
+int  usr_sha512_import(usr_sha512_ctx *ctx, const uint8_t in[USR_SHA512_EXPORT_SIZE]);
+
 /* ============================================================
    HMAC-SHA256
    ============================================================ */
@@ -75,8 +163,69 @@ void usr_hmac_sha256(const uint8_t *key, size_t key_len,
                      const uint8_t *data, size_t data_len,
                      uint8_t out[32]);
 
+/* Keyed HMAC-SHA256 for MACing many messages under one key: init
+   hashes the padded key blocks once; start() and keyed() then only
+   copy the stored midstates. Wipe the key object when done. */
+typedef struct {
+    usr_sha256_ctx inner;   /* state after K ^ ipad */
+    usr_sha256_ctx outer;   /* state after K ^ opad */
+} usr_hmac_sha256_key;
+
+void usr_hmac_sha256_key_init(usr_hmac_sha256_key *hk,
+                              const uint8_t *key, size_t key_len);
+void usr_hmac_sha256_key_wipe(usr_hmac_sha256_key *hk);
+
+/* Begin a streaming MAC (then _update / _final as usual) */
+void usr_hmac_sha256_start(usr_hmac_sha256_ctx *ctx,
+                           const usr_hmac_sha256_key *hk);
+
+/* One-shot MAC under a prepared key */
+void usr_hmac_sha256_keyed(const usr_hmac_sha256_key *hk,
+                           const uint8_t *data, size_t data_len,
+                           uint8_t out[32]);
+
+/* ============================================================
+   HMAC-SHA512
+   Same interface as HMAC-SHA256 above, with 64-byte tags.
+   ============================================================ */
+
+#define USR_HMAC_SHA512_SIZE 64
+
+typedef struct {
+    usr_sha512_ctx inner;
+    usr_sha512_ctx outer;
+} usr_hmac_sha512_ctx;
+
+void usr_hmac_sha512_init(usr_hmac_sha512_ctx *ctx,
+                           const uint8_t *key, size_t key_len);
+void usr_hmac_sha512_update(usr_hmac_sha512_ctx *ctx,
+                             const uint8_t *data, size_t len);
+void usr_hmac_sha512_final(usr_hmac_sha512_ctx *ctx, uint8_t out[64]);
+
+/* One-shot HMAC-SHA512 */
+void usr_hmac_sha512(const uint8_t *key, size_t key_len,
+                     const uint8_t *data, size_t data_len,
+                     uint8_t out[64]);
+
+/* Keyed HMAC-SHA512 (see usr_hmac_sha256_key) */
+typedef struct {
+    usr_sha512_ctx inner;   /* state after K ^ ipad */
+    usr_sha512_ctx outer;   /* state after K ^ opad */
+} usr_hmac_sha512_key;
+
+void usr_hmac_sha512_key_init(usr_hmac_sha512_key *hk,
+                              const uint8_t *key, size_t key_len);
+void usr_hmac_sha512_key_wipe(usr_hmac_sha512_key *hk);
+
+void usr_hmac_sha512_start(usr_hmac_sha512_ctx *ctx,
+                           const usr_hmac_sha512_key *hk);
+
+void usr_hmac_sha512_keyed(const usr_hmac_sha512_key *hk,
+                           const uint8_t *data, size_t data_len,
+                           uint8_t out[64]);
+
 /* ============================================================
-   PBKDF2-HMAC-SHA256
+   PBKDF2-HMAC-SHA256 / PBKDF2-HMAC-SHA512
    ============================================================ */
 
 /* Derive `out_len` bytes from password+salt with `iterations` rounds.
@@ -89,10 +238,57 @@ int usr_pbkdf2_sha256(
     uint8_t       *out,      size_t out_len
 );
 
+/* PBKDF2-HMAC-SHA512, same contract; out_len up to (2^32 - 1) * 64 */
+int usr_pbkdf2_sha512(
+    const uint8_t *password, size_t password_len,
+    const uint8_t *salt,     size_t salt_len,
+    uint32_t       iterations,
+    uint8_t       *out,      size_t out_len
+);
+
+/* Batch PBKDF2: derive keys for many independent (password, salt,
+   iterations) jobs, running their HMAC chains side by side in SIMD
+   lanes (SHA-256: 16 with AVX-512, 8 with AVX2; SHA-512: 8 with
+   AVX-512, 4 with AVX2). Iteration counts and
+   output lengths may differ between jobs. Returns 0, or -1 if any job
+   is invalid (nothing is written then). */
+typedef struct {
+    const uint8_t *password;
+    size_t         password_len;
+    const uint8_t *salt;
+    size_t         salt_len;
+    uint32_t       iterations;
+    uint8_t       *out;
+    size_t         out_len;
+} usr_pbkdf2_job;
+
+int usr_pbkdf2_sha256_many(const usr_pbkdf2_job *jobs, size_t n_jobs);
+int usr_pbkdf2_sha512_many(const usr_pbkdf2_job *jobs, size_t n_jobs);
+
 /* ============================================================
    AES-256 — Internal Block Operations
    ============================================================ */
 
+/* Block cipher implementations. AUTO picks AES-NI when the CPU has it
+   and falls back to TTABLE otherwise. TTABLE runs serial modes (IGE,
+   CBC encrypt) on T-tables and parallel ones (CTR, CBC decrypt) on the
+   constant-time bitsliced engine; BITSLICE uses the latter for all. */
+typedef enum {
+    USR_AES_IMPL_AUTO     = 0,
+    USR_AES_IMPL_BYTE     = 1,   /* byte-oriented reference tables */
+    USR_AES_IMPL_AESNI    = 2,   /* x86 AES-NI instructions */
+    USR_AES_IMPL_TTABLE   = 3,   /* 32-bit T-tables (Te0..3 / Td0..3) */
+    USR_AES_IMPL_BITSLICE = 4    /* bitsliced, constant-time */
+} usr_aes_impl;
+
+/* Force a specific implementation (e.g. for benchmarking).
+   Returns 0 on success, -1 if `impl` is not available on this CPU.
+   Process-wide and not thread-safe; call before using AES. */
+int usr_aes_set_impl(usr_aes_impl impl);
+
+/* Implementation currently used for AES block operations. */
+usr_aes_impl usr_aes_get_impl(void);
+
 /* AES-256 key schedule: 240 bytes of round keys (15 round keys × 16 bytes) */
 void usr_aes256_key_expand(const uint8_t key[32], uint8_t round_keys[240]);
 
@@ -102,6 +298,22 @@ void usr_aes256_encrypt_block(uint8_t block[16], const uint8_t round_keys[240]);
 /* Decrypt a single 16-byte block in-place */
 void usr_aes256_decrypt_block(uint8_t block[16], const uint8_t round_keys[240]);
 
+/* ============================================================
+   AES-256 Key Context
+   Expand a key once and reuse it across many mode calls.
+   ============================================================ */
+
+typedef struct {
+    uint8_t enc_rk[240];   /* encryption round keys */
+    uint8_t dec_rk[240];   /* equivalent inverse cipher round keys */
+} usr_aes256_ctx;
+
+/* Expand `key` into both encryption and decryption schedules. */
+void usr_aes256_init(usr_aes256_ctx *ctx, const uint8_t key[32]);
+
+/* Zero the round keys. */
+void usr_aes256_wipe(usr_aes256_ctx *ctx);
+
 /* ============================================================
    AES-256-IGE  (Telegram MTProto)
    ============================================================ */
@@ -124,6 +336,61 @@ int usr_aes256_ige_decrypt(
     const uint8_t  iv[32]
 );
 
+/* Same as above with a pre-expanded key. */
+int usr_aes256_ige_encrypt_ctx(
+    uint8_t              *data, size_t len,
+    const usr_aes256_ctx *ctx,
+    const uint8_t         iv[32]
+);
+int usr_aes256_ige_decrypt_ctx(
+    uint8_t              *data, size_t len,
+    const usr_aes256_ctx *ctx,
+    const uint8_t         iv[32]
+);
+
+/* Multi-buffer IGE: process many independent messages, each with its
+   own key and IV, in one call. Messages are interleaved so that several
+   blocks are in flight at once, which a single serial IGE stream can
+   never do. Each job is handled exactly like usr_aes256_ige_encrypt()
+   (or _decrypt()) on its own data. Returns -1 without touching any data
+   if a job is invalid (NULL pointer, length 0 or not a multiple of 16). */
+typedef struct {
+    uint8_t       *data;    /* in-place */
+    size_t         len;
+    const uint8_t *key;     /* 32 bytes */
+    const uint8_t *iv;      /* 32 bytes */
+} usr_aes256_ige_job;
+
+int usr_aes256_ige_encrypt_many(usr_aes256_ige_job *jobs, size_t n_jobs);
+int usr_aes256_ige_decrypt_many(usr_aes256_ige_job *jobs, size_t n_jobs);
+
+/* Streaming IGE for payloads that arrive in pieces. update() accepts
+   chunks of any size, writes every block it can complete and keeps
+   the rest (< 16 bytes) for the next call; *out_len holds the capacity
+   of `out` on entry (pending + in_len rounded down to 16 is enough)
+   and the bytes written on return, or the size needed with -1.
+   In-place use works as for usr_aes256_cbc_ctx: `out` may equal `in`
+   or trail it by the bytes the context holds.
+   final() wipes the context and returns -1 if a partial block is
+   left over. */
+typedef struct {
+    usr_aes256_ctx key;
+    uint8_t        prev_plain[16];    /* P_{i-1} */
+    uint8_t        prev_cipher[16];   /* C_{i-1} */
+    uint8_t        buf[16];           /* input not yet processed */
+    size_t         buflen;
+    int            decrypt;
+} usr_aes256_ige_ctx;
+
+int usr_aes256_ige_encrypt_init(usr_aes256_ige_ctx *ctx,
+                                const uint8_t key[32], const uint8_t iv[32]);
+int usr_aes256_ige_decrypt_init(usr_aes256_ige_ctx *ctx,
+                                const uint8_t key[32], const uint8_t iv[32]);
+int usr_aes256_ige_update(usr_aes256_ige_ctx *ctx,
+                          const uint8_t *in, size_t in_len,
+                          uint8_t *out, size_t *out_len);
+int usr_aes256_ige_final(usr_aes256_ige_ctx *ctx);
+
 /* ============================================================
    AES-256-CBC
    ============================================================ */
@@ -148,6 +415,55 @@ int usr_aes256_cbc_decrypt(
     uint8_t       *out, size_t *out_len
 );
 
+/* Same as above with a pre-expanded key. */
+int usr_aes256_cbc_encrypt_ctx(
+    const uint8_t        *in,  size_t in_len,
+    const usr_aes256_ctx *ctx,
+    const uint8_t         iv[16],
+    uint8_t              *out, size_t *out_len
+);
+int usr_aes256_cbc_decrypt_ctx(
+    const uint8_t        *in,  size_t in_len,
+    const usr_aes256_ctx *ctx,
+    const uint8_t         iv[16],
+    uint8_t              *out, size_t *out_len
+);
+
+/* Streaming CBC. update() takes any amount of input and writes only
+   whole blocks; *out_len holds the capacity of `out` on entry and the
+   bytes written on return. If it is too small, *out_len is set to the
+   size needed and -1 returned without consuming input. Encryption
+   writes every block it can complete (capacity needed: pending +
+   in_len rounded down to 16); decryption holds back the last block
+   for the padding check. To work in place over one buffer, point
+   `out` at the first byte not yet written: it trails `in` by the
+   bytes the context is holding, and `out` == `in` when none are.
+   final() needs 16 bytes of output space, writes the padded last block
+   (encrypt) or the unpadded tail (decrypt), and wipes the context.
+   Decrypt final() returns -1 on bad padding or truncated input. */
+typedef struct {
+    usr_aes256_ctx key;
+    uint8_t        iv[16];      /* previous ciphertext block */
+    uint8_t        buf[16];     /* input not yet processed */
+    size_t         buflen;
+} usr_aes256_cbc_ctx;
+
+int usr_aes256_cbc_encrypt_init(usr_aes256_cbc_ctx *ctx,
+                                const uint8_t key[32], const uint8_t iv[16]);
+int usr_aes256_cbc_encrypt_update(usr_aes256_cbc_ctx *ctx,
+                                  const uint8_t *in, size_t in_len,
+                                  uint8_t *out, size_t *out_len);
+int usr_aes256_cbc_encrypt_final(usr_aes256_cbc_ctx *ctx,
+                                 uint8_t *out, size_t *out_len);
+
+int usr_aes256_cbc_decrypt_init(usr_aes256_cbc_ctx *ctx,
+                                const uint8_t key[32], const uint8_t iv[16]);
+int usr_aes256_cbc_decrypt_update(usr_aes256_cbc_ctx *ctx,
+                                  const uint8_t *in, size_t in_len,
+                                  uint8_t *out, size_t *out_len);
+int usr_aes256_cbc_decrypt_final(usr_aes256_cbc_ctx *ctx,
+                                 uint8_t *out, size_t *out_len);
+
 /* ============================================================
    AES-256-CTR  (no padding, arbitrary length)
    ============================================================ */
@@ -161,15 +477,111 @@ int usr_aes256_ctr_crypt(
     uint8_t        nonce[16]   /* updated in-place for streaming */
 );
 
+/* Same as above with a pre-expanded key. */
+int usr_aes256_ctr_crypt_ctx(
+    uint8_t              *data, size_t len,
+    const usr_aes256_ctx *ctx,
+    uint8_t               nonce[16]
+);
+
+/* Same as usr_aes256_ctr_crypt_ctx() with a wider counter: the last
+   `counter_bits` / 8 bytes of `nonce` are a big-endian counter that
+   carries across byte boundaries. counter_bits must be 32 (default
+   layout), 64 (64-bit nonce + 64-bit counter) or 128 (whole block).
+   Returns -1 for any other width. */
+int usr_aes256_ctr_crypt_ex(
+    uint8_t              *data, size_t len,
+    const usr_aes256_ctx *ctx,
+    uint8_t               nonce[16],
+    unsigned              counter_bits
+);
+
+/* ============================================================
+   AES-256-GCM  (NIST SP 800-38D, authenticated encryption)
+   ============================================================ */
+
+/* One-shot GCM. Any IV length > 0 is accepted; 12 bytes is the fast
+   and recommended case. `in` and `out` may be equal.
+   Decryption checks the first `tag_len` (12..16) bytes of the tag in
+   constant time; on mismatch `out` is zeroed and -1 returned.
+   Returns 0 on success, -1 on error. */
+int usr_aes256_gcm_encrypt(
+    const uint8_t  key[32],
+    const uint8_t *iv,  size_t iv_len,
+    const uint8_t *aad, size_t aad_len,
+    const uint8_t *in,  size_t len,
+    uint8_t       *out,
+    uint8_t        tag[16]
+);
+int usr_aes256_gcm_decrypt(
+    const uint8_t  key[32],
+    const uint8_t *iv,  size_t iv_len,
+    const uint8_t *aad, size_t aad_len,
+    const uint8_t *in,  size_t len,
+    uint8_t       *out,
+    const uint8_t *tag, size_t tag_len
+);
+
+/* Streaming GCM: init, any number of aad() calls, any number of
+   update() calls (any lengths, `in` may equal `out`), then final().
+   aad() fails once update() has been called. final() wipes the
+   context. Streaming decryption releases plaintext before the tag is
+   checked, so callers must discard it if decrypt_final() returns -1. */
+typedef struct {
+    usr_aes256_ctx key;
+    uint64_t       htable[32];  /* GHASH multiplication table for H */
+    uint8_t        hpow[64];    /* H^1..H^4 for aggregated GHASH */
+    uint8_t        ctr[16];     /* next counter block */
+    uint8_t        ek0[16];     /* E(K, J0), masks the tag */
+    uint8_t        y[16];       /* GHASH accumulator */
+    uint8_t        buf[16];     /* AAD / ciphertext not yet hashed */
+    uint8_t        ks[16];      /* keystream for a partial block */
+    size_t         buflen;
+    size_t         ks_used;
+    uint64_t       aad_len;
+    uint64_t       data_len;
+    int            phase;
+} usr_aes256_gcm_ctx;
+
+int usr_aes256_gcm_init(usr_aes256_gcm_ctx *ctx, const uint8_t key[32],
+                        const uint8_t *iv, size_t iv_len);
+int usr_aes256_gcm_aad(usr_aes256_gcm_ctx *ctx, const uint8_t *aad, size_t len);
+int usr_aes256_gcm_encrypt_update(usr_aes256_gcm_ctx *ctx, const uint8_t *in,
+                                  uint8_t *out, size_t len);
+int usr_aes256_gcm_decrypt_update(usr_aes256_gcm_ctx *ctx, const uint8_t *in,
+                                  uint8_t *out, size_t len);
+int usr_aes256_gcm_encrypt_final(usr_aes256_gcm_ctx *ctx, uint8_t tag[16]);
+int usr_aes256_gcm_decrypt_final(usr_aes256_gcm_ctx *ctx,
+                                 const uint8_t *tag, size_t tag_len);
+
+/* Zero the context (final() already does this). */
+void usr_aes256_gcm_wipe(usr_aes256_gcm_ctx *ctx);
+
 /* ============================================================
    CRC32  (IEEE 802.3 / zlib polynomial)
    ============================================================ */
 
 /* Compute CRC-32 of data. Initial value is 0xFFFFFFFF.
-   Chain calls: crc = usr_crc32_update(crc, data, len). */
+   Chain calls: crc = usr_crc32_update(crc, data, len).
+   Buffers of 8 MiB or more (e.g. an mmap'd file) are split across
+   threads; see usr_crypto_set_threads(). */
 uint32_t usr_crc32(const uint8_t *data, size_t len);
 uint32_t usr_crc32_update(uint32_t crc, const uint8_t *data, size_t len);
 
+/* CRC-32 of A || B given crc_a = usr_crc32(A), crc_b = usr_crc32(B)
+   and len_b = |B|. Lets independently checksummed chunks be merged. */
+uint32_t usr_crc32_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b);
+
+/* ============================================================
+   CRC-32C  (Castagnoli polynomial, as used by iSCSI/ext4)
+   ============================================================ */
+
+/* Same conventions as usr_crc32 / usr_crc32_update / usr_crc32_combine.
+   Uses the SSE4.2 crc32 instruction when available. */
+uint32_t usr_crc32c(const uint8_t *data, size_t len);
+uint32_t usr_crc32c_update(uint32_t crc, const uint8_t *data, size_t len);
+uint32_t usr_crc32c_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b);
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,6 +40,50 @@ uint8_t *usr_base64_decode_alloc(const char *in, size_t in_len, size_t *out_len)
 char    *usr_base64url_encode_alloc(const uint8_t *in, size_t in_len);
 uint8_t *usr_base64url_decode_alloc(const char *in, size_t in_len, size_t *out_len);
 
+/* Streaming Base64 for inputs that do not fit in memory.
+   Chunks may be split anywhere; the concatenated output equals the
+   one-shot functions' output for the whole input. */
+typedef struct {
+    uint8_t pending[3];     /* incomplete group (up to 2 bytes) */
+    uint8_t npending;
+    uint8_t url;            /* URL-safe alphabet, no padding */
+} usr_base64_enc_ctx;
+
+void usr_base64_encode_init(usr_base64_enc_ctx *ctx);
+void usr_base64url_encode_init(usr_base64_enc_ctx *ctx);
+
+/* `out` must be at least usr_base64_enc_size(in_len) bytes.
+   Returns characters written; no NUL terminator. */
+size_t usr_base64_encode_update(usr_base64_enc_ctx *ctx, const uint8_t *in, size_t in_len,
+                                char *out);
+
+/* Writes the last group (up to 4 characters) and a NUL terminator,
+   so `out` needs 5 bytes. Returns characters written (excluding NUL)
+   and resets the context. */
+size_t usr_base64_encode_final(usr_base64_enc_ctx *ctx, char *out);
+
+/* Accepts both alphabets. Whitespace between quartets is skipped,
+   including across chunk boundaries; input after padding is ignored. */
+typedef struct {
+    uint8_t quad[4];        /* incomplete quartet (6-bit values) */
+    uint8_t nquad;
+    uint8_t done;           /* padding seen */
+    uint8_t error;          /* invalid input seen; sticky */
+} usr_base64_dec_ctx;
+
+void usr_base64_decode_init(usr_base64_dec_ctx *ctx);
+
+/* `out` must be at least usr_base64_dec_size(in_len) bytes.
+   Returns bytes written (no NUL), or (size_t)-1 on invalid input. */
+size_t usr_base64_decode_update(usr_base64_dec_ctx *ctx, const char *in, size_t in_len,
+                                uint8_t *out);
+
+/* Writes the bytes of an unpadded final quartet (up to 2) and a NUL,
+   so `out` needs 3 bytes. Returns bytes written, or (size_t)-1 if the
+   input was invalid or ended after a lone character. Resets the
+   context. */
+size_t usr_base64_decode_final(usr_base64_dec_ctx *ctx, uint8_t *out);
+
 /* ============================================================
    Hex (lowercase and uppercase)
    ============================================================ */
@@ -10,7 +10,11 @@ extern "C" {
 
 /* ============================================================
    Cryptographically Secure Random Bytes
-   Uses /dev/urandom on POSIX, getrandom() where available.
+   Output comes from a per-thread AES-256-CTR generator with fast key
+   erasure, seeded from getrandom() (or /dev/urandom) on first use,
+   reseeded every 1 MiB of output and again in a child after fork().
+   Small requests are served from a buffered keystream, so they do
+   not cost a system call.
    ============================================================ */
 
 /* Fill `out` with `len` cryptographically random bytes.
@@ -26,6 +30,12 @@ uint32_t usr_rand_u32(void);
 /* Generate a random value in [0, max). Returns 0 if max == 0. */
 uint64_t usr_rand_range(uint64_t max);
 
+/* Fill `out` with `n` independent uniform values in [0, max)
+   (all 0 if max == 0). Much cheaper than n usr_rand_range() calls.
+   Returns 0 on success, -1 on failure. */
+int usr_rand_fill_range(uint64_t *out, size_t n, uint64_t max);
+int usr_rand_fill_range_u32(uint32_t *out, size_t n, uint32_t max);
+
 #ifdef __cplusplus
 }
 #endif
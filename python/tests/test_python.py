@@ -35,6 +35,7 @@ def section(name):
 section("SHA-256 / SHA-512")
 check("sha256(abc)",    usr.sha256(b"abc"),  hashlib.sha256(b"abc").digest())
 check("sha256(empty)",  usr.sha256(b""),     hashlib.sha256(b"").digest())
+check("sha1(abc)",      usr.sha1(b"abc"),    hashlib.sha1(b"abc").digest())
 check("sha512(abc)",    usr.sha512(b"abc"),  hashlib.sha512(b"abc").digest())
 
 # HMAC
@@ -43,12 +44,17 @@ key = b"\x0b" * 20; data = b"Hi There"
 check("hmac RFC4231 #1",
       usr.hmac_sha256(key, data),
       _hmac.new(key, data, "sha256").digest())
+check("hmac-sha512 RFC4231 #1",
+      usr.hmac_sha512(key, data),
+      _hmac.new(key, data, "sha512").digest())
 
 # PBKDF2
 section("PBKDF2-HMAC-SHA256")
 dk = usr.pbkdf2_sha256(b"password", b"salt", 1, 32)
 check("length 32", len(dk), 32)
 check("value", dk, hashlib.pbkdf2_hmac("sha256", b"password", b"salt", 1, 32))
+check("sha512 c=100000", usr.pbkdf2_sha512(b"password", b"salt", 100000),
+      hashlib.pbkdf2_hmac("sha512", b"password", b"salt", 100000, 64))
 
 # AES-256-IGE
 section("AES-256-IGE")
@@ -78,6 +84,9 @@ check("ctr symmetric", usr.aes256_ctr_crypt(ct, k32, nonce), msg)
 # CRC-32
 section("CRC-32")
 check("crc32(123456789)", usr.crc32(b"123456789"), 0xCBF43926)
+check("crc32_combine",    usr.crc32_combine(usr.crc32(b"1234"), usr.crc32(b"56789"), 5), 0xCBF43926)
+check("crc32c(123456789)", usr.crc32c(b"123456789"), 0xE3069283)
+check("crc32c_combine",   usr.crc32c_combine(usr.crc32c(b"1234"), usr.crc32c(b"56789"), 5), 0xE3069283)
 
 # Base64
 section("Base64")
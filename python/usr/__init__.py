@@ -2,10 +2,12 @@
 usr — Universal Systems Runtime v0.1.3
 Python bindings for the usr C library.
 """
-from .crypto   import (sha256, sha512, hmac_sha256, pbkdf2_sha256,
+from .crypto   import (sha1, sha256, sha512, hmac_sha256, hmac_sha512,
+                        pbkdf2_sha256, pbkdf2_sha512,
                         aes256_ige_encrypt, aes256_ige_decrypt,
                         aes256_cbc_encrypt, aes256_cbc_decrypt,
-                        aes256_ctr_crypt, crc32, random_bytes)
+                        aes256_ctr_crypt, crc32, crc32_combine,
+                        crc32c, crc32c_combine, random_bytes)
 from .encoding import (base64_encode, base64_decode, base64url_encode, base64url_decode,
                         hex_encode, hex_decode, url_encode, url_decode,
                         html_escape, html_unescape)
@@ -18,10 +20,10 @@ __version__ = "0.1.3"
 __all__ = [
     "__version__",
     # crypto
-    "sha256","sha512","hmac_sha256","pbkdf2_sha256",
+    "sha1","sha256","sha512","hmac_sha256","hmac_sha512","pbkdf2_sha256","pbkdf2_sha512",
     "aes256_ige_encrypt","aes256_ige_decrypt",
     "aes256_cbc_encrypt","aes256_cbc_decrypt","aes256_ctr_crypt",
-    "crc32","random_bytes",
+    "crc32","crc32_combine","crc32c","crc32c_combine","random_bytes",
     # encoding
     "base64_encode","base64_decode","base64url_encode","base64url_decode",
     "hex_encode","hex_decode","url_encode","url_decode",
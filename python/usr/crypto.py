@@ -1,4 +1,4 @@
-"""usr.crypto — SHA-256/512, HMAC, PBKDF2, AES-256-IGE/CBC/CTR, CRC-32, secure random."""
+"""usr.crypto — SHA-1/256/512, HMAC, PBKDF2, AES-256-IGE/CBC/CTR, CRC-32/32C, secure random."""
 from __future__ import annotations
 import ctypes
 from ._lib import lib, libc
@@ -11,6 +11,13 @@ def _buf(data: bytes) -> ctypes.Array:
 def _check(v, name: str) -> bytes:
     return bytes(v) if isinstance(v, (bytes, bytearray, memoryview)) else (_ for _ in ()).throw(TypeError(f"{name} must be bytes"))
 
+# SHA-1
+lib.usr_sha1.argtypes = [ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t, ctypes.POINTER(ctypes.c_uint8)]
+lib.usr_sha1.restype = None
+def sha1(data: bytes) -> bytes:
+    data = bytes(data); out = (ctypes.c_uint8 * 20)()
+    lib.usr_sha1(_buf(data), len(data), out); return bytes(out)
+
 # SHA-256
 lib.usr_sha256.argtypes = [ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t, ctypes.POINTER(ctypes.c_uint8)]
 lib.usr_sha256.restype = None
@@ -34,6 +41,13 @@ def hmac_sha256(key: bytes, data: bytes) -> bytes:
     key, data = bytes(key), bytes(data); out = (ctypes.c_uint8 * 32)()
     lib.usr_hmac_sha256(_buf(key), len(key), _buf(data), len(data), out); return bytes(out)
 
+# HMAC-SHA512
+lib.usr_hmac_sha512.argtypes = lib.usr_hmac_sha256.argtypes
+lib.usr_hmac_sha512.restype = None
+def hmac_sha512(key: bytes, data: bytes) -> bytes:
+    key, data = bytes(key), bytes(data); out = (ctypes.c_uint8 * 64)()
+    lib.usr_hmac_sha512(_buf(key), len(key), _buf(data), len(data), out); return bytes(out)
+
 # PBKDF2
 lib.usr_pbkdf2_sha256.argtypes = [ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t,
                                     ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t,
@@ -44,6 +58,14 @@ def pbkdf2_sha256(password: bytes, salt: bytes, iterations: int, length: int = 3
     lib.usr_pbkdf2_sha256(_buf(p), len(p), _buf(s), len(s), int(iterations), out, length)
     return bytes(out)
 
+lib.usr_pbkdf2_sha512.argtypes = lib.usr_pbkdf2_sha256.argtypes
+lib.usr_pbkdf2_sha512.restype = ctypes.c_int
+def pbkdf2_sha512(password: bytes, salt: bytes, iterations: int, length: int = 64) -> bytes:
+    p, s = bytes(password), bytes(salt); out = (ctypes.c_uint8 * length)()
+    if lib.usr_pbkdf2_sha512(_buf(p), len(p), _buf(s), len(s), int(iterations), out, length) != 0:
+        raise ValueError("invalid PBKDF2 parameters")
+    return bytes(out)
+
 # AES-256-IGE
 lib.usr_aes256_ige_encrypt.argtypes = [ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t,
                                          ctypes.POINTER(ctypes.c_uint8), ctypes.POINTER(ctypes.c_uint8)]
@@ -107,6 +129,22 @@ lib.usr_crc32.restype  = ctypes.c_uint32
 def crc32(data: bytes) -> int:
     data = bytes(data); return lib.usr_crc32(_buf(data), len(data))
 
+lib.usr_crc32_combine.argtypes = [ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint64]
+lib.usr_crc32_combine.restype  = ctypes.c_uint32
+def crc32_combine(crc_a: int, crc_b: int, len_b: int) -> int:
+    return lib.usr_crc32_combine(crc_a, crc_b, len_b)
+
+# CRC-32C
+lib.usr_crc32c.argtypes = [ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t]
+lib.usr_crc32c.restype  = ctypes.c_uint32
+def crc32c(data: bytes) -> int:
+    data = bytes(data); return lib.usr_crc32c(_buf(data), len(data))
+
+lib.usr_crc32c_combine.argtypes = [ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint64]
+lib.usr_crc32c_combine.restype  = ctypes.c_uint32
+def crc32c_combine(crc_a: int, crc_b: int, len_b: int) -> int:
+    return lib.usr_crc32c_combine(crc_a, crc_b, len_b)
+
 # Secure random
 lib.usr_rand_bytes.argtypes = [ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t]
 lib.usr_rand_bytes.restype  = ctypes.c_int
@@ -115,7 +153,7 @@ def random_bytes(n: int) -> bytes:
     if lib.usr_rand_bytes(buf, n) != 0: raise RuntimeError("random_bytes failed")
     return bytes(buf)
 
-__all__ = ["sha256","sha512","hmac_sha256","pbkdf2_sha256",
+__all__ = ["sha1","sha256","sha512","hmac_sha256","hmac_sha512","pbkdf2_sha256","pbkdf2_sha512",
            "aes256_ige_encrypt","aes256_ige_decrypt",
            "aes256_cbc_encrypt","aes256_cbc_decrypt","aes256_ctr_crypt",
-           "crc32","random_bytes"]
+           "crc32","crc32_combine","crc32c","crc32c_combine","random_bytes"]
@@ -0,0 +1,139 @@
+#include "aes_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+#include <string.h>
+
+/* ============================================================
+   AES backend selection
+   AUTO resolves on every lookup (one load + test), so it follows
+   usr_cpu_disable() without any re-initialisation.
+   ============================================================ */
+
+static void byte_encrypt_blocks(const uint8_t *in, uint8_t *out,
+                                size_t nblocks, const uint8_t rk[240]) {
+    for (size_t i = 0; i < nblocks; i++) {
+        if (out != in) memcpy(out + 16 * i, in + 16 * i, 16);
+        usr_aes_byte_encrypt(out + 16 * i, rk);
+    }
+}
+
+static void byte_decrypt_blocks(const uint8_t *in, uint8_t *out,
+                                size_t nblocks, const uint8_t drk[240]) {
+    for (size_t i = 0; i < nblocks; i++) {
+        if (out != in) memcpy(out + 16 * i, in + 16 * i, 16);
+        usr_aes_byte_decrypt(out + 16 * i, drk);
+    }
+}
+
+static const usr_aes_backend backend_byte = {
+    USR_AES_IMPL_BYTE,
+    usr_aes_byte_key_expand,
+    usr_aes_byte_invert_key,
+    usr_aes_byte_encrypt,
+    usr_aes_byte_decrypt,
+    byte_encrypt_blocks,
+    byte_decrypt_blocks,
+    NULL,
+    NULL
+};
+
+/* T-tables for serial single-block work; independent blocks go
+   through the bitsliced engine, which is constant-time. */
+static const usr_aes_backend backend_ttable = {
+    USR_AES_IMPL_TTABLE,
+    usr_aes_byte_key_expand,
+    usr_aes_byte_invert_key,
+    usr_aes_ttable_encrypt,
+    usr_aes_ttable_decrypt,
+    usr_aes_bitslice_encrypt_blocks,
+    usr_aes_bitslice_decrypt_blocks,
+    NULL,
+    NULL
+};
+
+static const usr_aes_backend backend_bitslice = {
+    USR_AES_IMPL_BITSLICE,
+    usr_aes_bitslice_key_expand,
+    usr_aes_bitslice_invert_key,
+    usr_aes_bitslice_encrypt,
+    usr_aes_bitslice_decrypt,
+    usr_aes_bitslice_encrypt_blocks,
+    usr_aes_bitslice_decrypt_blocks,
+    NULL,
+    NULL
+};
+
+static const usr_aes_backend *_forced = NULL;
+
+static int aesni_usable(void) {
+    return usr_aesni_compiled() && usr_cpu_has(USR_CPU_AESNI);
+}
+
+const usr_aes_backend *usr_aes_backend_get(void) {
+    if (_forced) return _forced;
+    return aesni_usable() ? &usr_aes_backend_aesni : &backend_ttable;
+}
+
+int usr_aes_set_impl(usr_aes_impl impl) {
+    switch (impl) {
+        case USR_AES_IMPL_AUTO:
+            _forced = NULL;
+            return 0;
+        case USR_AES_IMPL_BYTE:
+            _forced = &backend_byte;
+            return 0;
+        case USR_AES_IMPL_TTABLE:
+            _forced = &backend_ttable;
+            return 0;
+        case USR_AES_IMPL_BITSLICE:
+            _forced = &backend_bitslice;
+            return 0;
+        case USR_AES_IMPL_AESNI:
+            if (!aesni_usable()) return -1;
+            _forced = &usr_aes_backend_aesni;
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+usr_aes_impl usr_aes_get_impl(void) {
+    return usr_aes_backend_get()->id;
+}
+
+/* ============================================================
+   Public single-block API
+   ============================================================ */
+
+void usr_aes256_key_expand(const uint8_t key[32], uint8_t round_keys[240]) {
+    usr_aes_backend_get()->key_expand(key, round_keys);
+}
+
+void usr_aes256_encrypt_block(uint8_t block[16], const uint8_t round_keys[240]) {
+    usr_aes_backend_get()->encrypt(block, round_keys);
+}
+
+/* Takes the encryption schedule, so the decryption schedule is derived
+   per call; usr_aes256_ctx keeps a precomputed one. */
+void usr_aes256_decrypt_block(uint8_t block[16], const uint8_t round_keys[240]) {
+    const usr_aes_backend *be = usr_aes_backend_get();
+    uint8_t drk[240];
+    be->invert_key(round_keys, drk);
+    be->decrypt(block, drk);
+    memset(drk, 0, sizeof(drk));
+}
+
+/* ============================================================
+   Key context
+   ============================================================ */
+
+void usr_aes256_init(usr_aes256_ctx *ctx, const uint8_t key[32]) {
+    if (!ctx || !key) return;
+    const usr_aes_backend *be = usr_aes_backend_get();
+    be->key_expand(key, ctx->enc_rk);
+    be->invert_key(ctx->enc_rk, ctx->dec_rk);
+}
+
+void usr_aes256_wipe(usr_aes256_ctx *ctx) {
+    if (ctx) memset(ctx, 0, sizeof(*ctx));
+}
@@ -0,0 +1,489 @@
+#include "aes_impl.h"
+#include <stdint.h>
+#include <string.h>
+
+/* ============================================================
+   AES-256 — bitsliced, constant-time implementation
+
+   Four blocks are spread over eight 64-bit words so that word i
+   holds bit i of every state byte; SubBytes then becomes a fixed
+   Boolean circuit (Boyar–Peralta) and ShiftRows/MixColumns become
+   shifts and rotations. No table is indexed by secret data.
+
+   Bulk calls run two such 4-block groups through the rounds side by
+   side (8 blocks per step), which gives the compiler independent
+   work to schedule and lets it pair words into SSE2 registers.
+   ============================================================ */
+
+#define LOAD32LE(p)  ((uint32_t)(p)[0]         | ((uint32_t)(p)[1] << 8) | \
+                     ((uint32_t)(p)[2] << 16)  | ((uint32_t)(p)[3] << 24))
+
+static inline void store32le(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;         p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+/* ============================================================
+   S-box circuit (113 gates: 32 AND, 77 XOR, 4 XNOR)
+   ============================================================ */
+
+static void bs_sbox(uint64_t q[8]) {
+    uint64_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint64_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint64_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint64_t y20, y21;
+    uint64_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint64_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint64_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint64_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint64_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint64_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint64_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint64_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint64_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint64_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7]; x1 = q[6]; x2 = q[5]; x3 = q[4];
+    x4 = q[3]; x5 = q[2]; x6 = q[1]; x7 = q[0];
+
+    /* Top linear transformation */
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9  = x0 ^ x3;
+    y8  = x0 ^ x5;
+    t0  = x1 ^ x2;
+    y1  = t0 ^ x7;
+    y4  = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2  = y1 ^ x0;
+    y5  = y1 ^ x6;
+    y3  = y5 ^ y8;
+    t1  = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6  = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7  = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    /* Non-linear section (GF(2^4) inversion) */
+    t2  = y12 & y15;
+    t3  = y3 & y6;
+    t4  = t3 ^ t2;
+    t5  = y4 & x7;
+    t6  = t5 ^ t2;
+    t7  = y13 & y16;
+    t8  = y5 & y1;
+    t9  = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0  = t44 & y15;
+    z1  = t37 & y6;
+    z2  = t33 & x7;
+    z3  = t43 & y16;
+    z4  = t40 & y1;
+    z5  = t29 & y7;
+    z6  = t42 & y11;
+    z7  = t45 & y17;
+    z8  = t41 & y10;
+    z9  = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    /* Bottom linear transformation */
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0  = t59 ^ t63;
+    s6  = t56 ^ ~t62;
+    s7  = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3  = t53 ^ t66;
+    s4  = t51 ^ t66;
+    s5  = t47 ^ t65;
+    s1  = t64 ^ ~s3;
+    s2  = t55 ^ ~t67;
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+/* Inverse affine map A'(y) = L^-1(y ^ 0x63), applied bitwise.
+   Since S(x) = L(x^-1) ^ 0x63, InvS(y) = A'(S(A'(y))). */
+static void bs_inv_affine(uint64_t q[8]) {
+    uint64_t q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3];
+    uint64_t q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+static void bs_inv_sbox(uint64_t q[8]) {
+    bs_inv_affine(q);
+    bs_sbox(q);
+    bs_inv_affine(q);
+}
+
+/* ============================================================
+   Bit transposition between byte and bitsliced layouts
+   ============================================================ */
+
+#define SWAPN(cl, ch, s, x, y) do {                         \
+        uint64_t a_ = (x), b_ = (y);                        \
+        (x) = (a_ & (uint64_t)(cl)) | ((b_ & (uint64_t)(cl)) << (s)); \
+        (y) = ((a_ & (uint64_t)(ch)) >> (s)) | (b_ & (uint64_t)(ch)); \
+    } while (0)
+
+#define SWAP2(x, y) SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, x, y)
+#define SWAP4(x, y) SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, x, y)
+#define SWAP8(x, y) SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, x, y)
+
+static void bs_ortho(uint64_t q[8]) {
+    SWAP2(q[0], q[1]); SWAP2(q[2], q[3]); SWAP2(q[4], q[5]); SWAP2(q[6], q[7]);
+    SWAP4(q[0], q[2]); SWAP4(q[1], q[3]); SWAP4(q[4], q[6]); SWAP4(q[5], q[7]);
+    SWAP8(q[0], q[4]); SWAP8(q[1], q[5]); SWAP8(q[2], q[6]); SWAP8(q[3], q[7]);
+}
+
+/* Spread one block (four LE column words) over two 64-bit words */
+static void bs_interleave_in(uint64_t *q0, uint64_t *q1, const uint8_t *in) {
+    uint64_t x0 = LOAD32LE(in),     x1 = LOAD32LE(in + 4);
+    uint64_t x2 = LOAD32LE(in + 8), x3 = LOAD32LE(in + 12);
+    x0 |= (x0 << 16); x1 |= (x1 << 16); x2 |= (x2 << 16); x3 |= (x3 << 16);
+    x0 &= 0x0000FFFF0000FFFFULL; x1 &= 0x0000FFFF0000FFFFULL;
+    x2 &= 0x0000FFFF0000FFFFULL; x3 &= 0x0000FFFF0000FFFFULL;
+    x0 |= (x0 << 8); x1 |= (x1 << 8); x2 |= (x2 << 8); x3 |= (x3 << 8);
+    x0 &= 0x00FF00FF00FF00FFULL; x1 &= 0x00FF00FF00FF00FFULL;
+    x2 &= 0x00FF00FF00FF00FFULL; x3 &= 0x00FF00FF00FF00FFULL;
+    *q0 = x0 | (x2 << 8);
+    *q1 = x1 | (x3 << 8);
+}
+
+static void bs_interleave_out(uint8_t *out, uint64_t q0, uint64_t q1) {
+    uint64_t x0 = q0 & 0x00FF00FF00FF00FFULL;
+    uint64_t x1 = q1 & 0x00FF00FF00FF00FFULL;
+    uint64_t x2 = (q0 >> 8) & 0x00FF00FF00FF00FFULL;
+    uint64_t x3 = (q1 >> 8) & 0x00FF00FF00FF00FFULL;
+    x0 |= (x0 >> 8); x1 |= (x1 >> 8); x2 |= (x2 >> 8); x3 |= (x3 >> 8);
+    x0 &= 0x0000FFFF0000FFFFULL; x1 &= 0x0000FFFF0000FFFFULL;
+    x2 &= 0x0000FFFF0000FFFFULL; x3 &= 0x0000FFFF0000FFFFULL;
+    store32le(out,      (uint32_t)x0 | (uint32_t)(x0 >> 16));
+    store32le(out + 4,  (uint32_t)x1 | (uint32_t)(x1 >> 16));
+    store32le(out + 8,  (uint32_t)x2 | (uint32_t)(x2 >> 16));
+    store32le(out + 12, (uint32_t)x3 | (uint32_t)(x3 >> 16));
+}
+
+/* Load up to 4 blocks (missing ones are zero) into bitsliced form */
+static void bs_load(uint64_t q[8], const uint8_t *in, size_t nblocks) {
+    uint8_t zero[16] = {0};
+    for (int i = 0; i < 4; i++) {
+        const uint8_t *b = ((size_t)i < nblocks) ? in + 16 * i : zero;
+        bs_interleave_in(&q[i], &q[i + 4], b);
+    }
+    bs_ortho(q);
+}
+
+static void bs_store(uint8_t *out, uint64_t q[8], size_t nblocks) {
+    bs_ortho(q);
+    for (int i = 0; i < 4; i++) {
+        if ((size_t)i < nblocks) bs_interleave_out(out + 16 * i, q[i], q[i + 4]);
+    }
+}
+
+/* ============================================================
+   Round functions
+   ============================================================ */
+
+static inline void bs_add_round_key(uint64_t q[8], const uint64_t *sk) {
+    for (int i = 0; i < 8; i++) q[i] ^= sk[i];
+}
+
+static inline void bs_shift_rows(uint64_t q[8]) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t x = q[i];
+        q[i] = (x & 0x000000000000FFFFULL)
+             | ((x & 0x00000000FFF00000ULL) >> 4)
+             | ((x & 0x00000000000F0000ULL) << 12)
+             | ((x & 0x0000FF0000000000ULL) >> 8)
+             | ((x & 0x000000FF00000000ULL) << 8)
+             | ((x & 0xF000000000000000ULL) >> 12)
+             | ((x & 0x0FFF000000000000ULL) << 4);
+    }
+}
+
+static inline void bs_inv_shift_rows(uint64_t q[8]) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t x = q[i];
+        q[i] = (x & 0x000000000000FFFFULL)
+             | ((x & 0x000000000FFF0000ULL) << 4)
+             | ((x & 0x00000000F0000000ULL) >> 12)
+             | ((x & 0x000000FF00000000ULL) << 8)
+             | ((x & 0x0000FF0000000000ULL) >> 8)
+             | ((x & 0x000F000000000000ULL) << 12)
+             | ((x & 0xFFF0000000000000ULL) >> 4);
+    }
+}
+
+static inline uint64_t rotr32(uint64_t x) {
+    return (x << 32) | (x >> 32);
+}
+
+static inline void bs_mix_columns(uint64_t q[8]) {
+    uint64_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    uint64_t q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    uint64_t r0 = (q0 >> 16) | (q0 << 48), r1 = (q1 >> 16) | (q1 << 48);
+    uint64_t r2 = (q2 >> 16) | (q2 << 48), r3 = (q3 >> 16) | (q3 << 48);
+    uint64_t r4 = (q4 >> 16) | (q4 << 48), r5 = (q5 >> 16) | (q5 << 48);
+    uint64_t r6 = (q6 >> 16) | (q6 << 48), r7 = (q7 >> 16) | (q7 << 48);
+
+    q[0] = q7 ^ r7 ^ r0 ^ rotr32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotr32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ rotr32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotr32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotr32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ rotr32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ rotr32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ rotr32(q7 ^ r7);
+}
+
+static inline void bs_inv_mix_columns(uint64_t q[8]) {
+    uint64_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    uint64_t q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    uint64_t r0 = (q0 >> 16) | (q0 << 48), r1 = (q1 >> 16) | (q1 << 48);
+    uint64_t r2 = (q2 >> 16) | (q2 << 48), r3 = (q3 >> 16) | (q3 << 48);
+    uint64_t r4 = (q4 >> 16) | (q4 << 48), r5 = (q5 >> 16) | (q5 << 48);
+    uint64_t r6 = (q6 >> 16) | (q6 << 48), r7 = (q7 >> 16) | (q7 << 48);
+
+    q[0] = q5 ^ q6 ^ q7 ^ r0 ^ r5 ^ r7 ^ rotr32(q0 ^ q5 ^ q6 ^ r0 ^ r5);
+    q[1] = q0 ^ q5 ^ r0 ^ r1 ^ r5 ^ r6 ^ r7 ^ rotr32(q1 ^ q5 ^ q7 ^ r1 ^ r5 ^ r6);
+    q[2] = q0 ^ q1 ^ q6 ^ r1 ^ r2 ^ r6 ^ r7 ^ rotr32(q0 ^ q2 ^ q6 ^ r2 ^ r6 ^ r7);
+    q[3] = q0 ^ q1 ^ q2 ^ q5 ^ q6 ^ r0 ^ r2 ^ r3 ^ r5
+         ^ rotr32(q0 ^ q1 ^ q3 ^ q5 ^ q6 ^ q7 ^ r0 ^ r3 ^ r5 ^ r7);
+    q[4] = q1 ^ q2 ^ q3 ^ q5 ^ r1 ^ r3 ^ r4 ^ r5 ^ r6 ^ r7
+         ^ rotr32(q1 ^ q2 ^ q4 ^ q5 ^ q7 ^ r1 ^ r4 ^ r5 ^ r6);
+    q[5] = q2 ^ q3 ^ q4 ^ q6 ^ r2 ^ r4 ^ r5 ^ r6 ^ r7
+         ^ rotr32(q2 ^ q3 ^ q5 ^ q6 ^ r2 ^ r5 ^ r6 ^ r7);
+    q[6] = q3 ^ q4 ^ q5 ^ q7 ^ r3 ^ r5 ^ r6 ^ r7
+         ^ rotr32(q3 ^ q4 ^ q6 ^ q7 ^ r3 ^ r6 ^ r7);
+    q[7] = q4 ^ q5 ^ q6 ^ r4 ^ r6 ^ r7
+         ^ rotr32(q4 ^ q5 ^ q7 ^ r4 ^ r7);
+}
+
+/* ============================================================
+   Bitsliced round keys: one 8-word group per round key,
+   replicated across the four block slots.
+   ============================================================ */
+
+#define BS_SKEY_WORDS (8 * (AES256_ROUNDS + 1))
+
+static void bs_expand_schedule(uint64_t sk[BS_SKEY_WORDS], const uint8_t rk[240]) {
+    for (int r = 0; r <= AES256_ROUNDS; r++) {
+        uint64_t *q = sk + 8 * r;
+        bs_interleave_in(&q[0], &q[4], rk + 16 * r);
+        q[1] = q[2] = q[3] = q[0];
+        q[5] = q[6] = q[7] = q[4];
+        bs_ortho(q);
+    }
+}
+
+/* Encrypt (inverse = 0) or decrypt with the equivalent inverse cipher
+   (inverse = 1) two 4-block groups in lockstep. */
+static void bs_rounds_x2(uint64_t qa[8], uint64_t qb[8],
+                         const uint64_t *sk, int inverse) {
+    bs_add_round_key(qa, sk);
+    bs_add_round_key(qb, sk);
+    for (int r = 1; r <= AES256_ROUNDS; r++) {
+        if (inverse) {
+            bs_inv_sbox(qa);         bs_inv_sbox(qb);
+            bs_inv_shift_rows(qa);   bs_inv_shift_rows(qb);
+            if (r < AES256_ROUNDS) {
+                bs_inv_mix_columns(qa); bs_inv_mix_columns(qb);
+            }
+        } else {
+            bs_sbox(qa);             bs_sbox(qb);
+            bs_shift_rows(qa);       bs_shift_rows(qb);
+            if (r < AES256_ROUNDS) {
+                bs_mix_columns(qa);  bs_mix_columns(qb);
+            }
+        }
+        bs_add_round_key(qa, sk + 8 * r);
+        bs_add_round_key(qb, sk + 8 * r);
+    }
+}
+
+static void bs_crypt_blocks(const uint8_t *in, uint8_t *out, size_t nblocks,
+                            const uint8_t sched[240], int inverse) {
+    uint64_t sk[BS_SKEY_WORDS];
+    uint64_t qa[8], qb[8];
+
+    bs_expand_schedule(sk, sched);
+
+    while (nblocks > 0) {
+        size_t na = nblocks < 4 ? nblocks : 4;
+        size_t nb = nblocks - na < 4 ? nblocks - na : 4;
+        bs_load(qa, in, na);
+        bs_load(qb, in + 16 * na, nb);
+        bs_rounds_x2(qa, qb, sk, inverse);
+        bs_store(out, qa, na);
+        bs_store(out + 16 * na, qb, nb);
+        in      += 16 * (na + nb);
+        out     += 16 * (na + nb);
+        nblocks -= na + nb;
+    }
+
+    memset(sk, 0, sizeof(sk));
+    memset(qa, 0, sizeof(qa));
+    memset(qb, 0, sizeof(qb));
+}
+
+void usr_aes_bitslice_encrypt_blocks(const uint8_t *in, uint8_t *out,
+                                     size_t nblocks, const uint8_t rk[240]) {
+    bs_crypt_blocks(in, out, nblocks, rk, 0);
+}
+
+void usr_aes_bitslice_decrypt_blocks(const uint8_t *in, uint8_t *out,
+                                     size_t nblocks, const uint8_t drk[240]) {
+    bs_crypt_blocks(in, out, nblocks, drk, 1);
+}
+
+void usr_aes_bitslice_encrypt(uint8_t block[16], const uint8_t rk[240]) {
+    bs_crypt_blocks(block, block, 1, rk, 0);
+}
+
+void usr_aes_bitslice_decrypt(uint8_t block[16], const uint8_t drk[240]) {
+    bs_crypt_blocks(block, block, 1, drk, 1);
+}
+
+/* ============================================================
+   Constant-time key schedule
+   ============================================================ */
+
+/* SubWord through the S-box circuit: one word is enough for ortho
+   to place each byte's bits in separate lanes. */
+static uint32_t bs_sub_word(uint32_t x) {
+    uint64_t q[8] = { x, 0, 0, 0, 0, 0, 0, 0 };
+    bs_ortho(q);
+    bs_sbox(q);
+    bs_ortho(q);
+    return (uint32_t)q[0];
+}
+
+void usr_aes_bitslice_key_expand(const uint8_t key[32], uint8_t rk[240]) {
+    uint32_t w[60];
+    uint32_t rcon = 0x01;
+
+    for (int i = 0; i < 8; i++) w[i] = LOAD32LE(key + 4 * i);
+    for (int i = 8; i < 60; i++) {
+        uint32_t tmp = w[i - 1];
+        if (i % 8 == 0) {
+            /* RotWord on LE words is a right rotate by 8 */
+            tmp = bs_sub_word((tmp >> 8) | (tmp << 24)) ^ rcon;
+            rcon <<= 1;
+        } else if (i % 8 == 4) {
+            tmp = bs_sub_word(tmp);
+        }
+        w[i] = w[i - 8] ^ tmp;
+    }
+    for (int i = 0; i < 60; i++) store32le(rk + 4 * i, w[i]);
+    memset(w, 0, sizeof(w));
+}
+
+/* GF(2^8) doubling without data-dependent branches or lookups */
+static inline uint8_t ct_xtime(uint8_t x) {
+    return (uint8_t)((x << 1) ^ (0x1B & (uint8_t)-(x >> 7)));
+}
+
+void usr_aes_bitslice_invert_key(const uint8_t rk[240], uint8_t drk[240]) {
+    memcpy(drk, rk + AES256_ROUNDS * 16, 16);
+    for (int r = 1; r < AES256_ROUNDS; r++) {
+        const uint8_t *k = rk + (AES256_ROUNDS - r) * 16;
+        uint8_t *d = drk + r * 16;
+        for (int c = 0; c < 16; c += 4) {
+            uint8_t a[4], a2[4], a4[4], a8[4];
+            for (int j = 0; j < 4; j++) {
+                a[j]  = k[c + j];
+                a2[j] = ct_xtime(a[j]);
+                a4[j] = ct_xtime(a2[j]);
+                a8[j] = ct_xtime(a4[j]);
+            }
+            /* 14 = 8+4+2, 11 = 8+2+1, 13 = 8+4+1, 9 = 8+1 */
+            for (int j = 0; j < 4; j++) {
+                int j1 = (j + 1) & 3, j2 = (j + 2) & 3, j3 = (j + 3) & 3;
+                d[c + j] = (uint8_t)((a8[j]  ^ a4[j]  ^ a2[j])
+                                   ^ (a8[j1] ^ a2[j1] ^ a[j1])
+                                   ^ (a8[j2] ^ a4[j2] ^ a[j2])
+                                   ^ (a8[j3] ^ a[j3]));
+            }
+        }
+    }
+    memcpy(drk + AES256_ROUNDS * 16, rk, 16);
+}
@@ -1,12 +1,8 @@
 #include "aes_tables.h"
-#include "usr/crypto.h"
+#include "aes_impl.h"
 #include <stdint.h>
 #include <string.h>
 
-extern void usr_aes_tables_init(void);
-
-/* AES-256: 14 rounds, 15 round keys (240 bytes) */
-#define AES256_ROUNDS    14
 #define AES256_RK_WORDS  60   /* 15 round keys * 4 words each */
 
 /* Rcon values for AES-256 key schedule (indices 1..7 are used) */
@@ -21,7 +17,7 @@ static const uint8_t rcon[15] = {
    Produces 240 bytes = 60 × 32-bit words = 15 round keys
    ============================================================ */
 
-void usr_aes256_key_expand(const uint8_t key[32], uint8_t round_keys[240]) {
+void usr_aes_byte_key_expand(const uint8_t key[32], uint8_t round_keys[240]) {
     usr_aes_tables_init();
 
     /* Copy the original key as the first 8 words (32 bytes) */
@@ -104,7 +100,7 @@ static void add_round_key(uint8_t s[16], const uint8_t *rk) {
    AES-256 Encrypt Block
    ============================================================ */
 
-void usr_aes256_encrypt_block(uint8_t block[16], const uint8_t rk[240]) {
+void usr_aes_byte_encrypt(uint8_t block[16], const uint8_t rk[240]) {
     /* Initial AddRoundKey */
     add_round_key(block, rk);
 
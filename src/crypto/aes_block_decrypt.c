@@ -1,16 +1,12 @@
 #include "aes_tables.h"
-#include "usr/crypto.h"
+#include "aes_impl.h"
 #include <stdint.h>
 #include <string.h>
 
-extern void usr_aes_tables_init(void);
-
 /* ============================================================
    AES-256 Decrypt Block — Full 14-round Inverse Cipher
    ============================================================ */
 
-#define AES256_ROUNDS 14
-
 /* Inverse SubBytes: apply inv_sbox to each byte */
 static void inv_sub_bytes(uint8_t s[16]) {
     for (int i = 0; i < 16; i++) s[i] = inv_sbox[s[i]];
@@ -65,27 +61,45 @@ static void add_round_key(uint8_t s[16], const uint8_t *rk) {
     for (int i = 0; i < 16; i++) s[i] ^= rk[i];
 }
 
+/* ============================================================
+   Decryption key schedule
+   Reverse the round keys and push InvMixColumns through the
+   middle ones, so decryption rounds have the same shape as
+   encryption rounds (FIPS 197 §5.3.5).
+   ============================================================ */
+
+void usr_aes_byte_invert_key(const uint8_t rk[240], uint8_t drk[240]) {
+    usr_aes_tables_init();
+
+    memcpy(drk, rk + AES256_ROUNDS * 16, 16);
+    for (int r = 1; r < AES256_ROUNDS; r++) {
+        memcpy(drk + r * 16, rk + (AES256_ROUNDS - r) * 16, 16);
+        inv_mix_columns(drk + r * 16);
+    }
+    memcpy(drk + AES256_ROUNDS * 16, rk, 16);
+}
+
 /* ============================================================
    Full AES-256 Decrypt Block
-   Equivalent Inverse Cipher (AES standard FIPS 197 §5.3)
+   Equivalent Inverse Cipher (AES standard FIPS 197 §5.3.5)
    ============================================================ */
 
-void usr_aes256_decrypt_block(uint8_t block[16], const uint8_t rk[240]) {
+void usr_aes_byte_decrypt(uint8_t block[16], const uint8_t drk[240]) {
     usr_aes_tables_init();
 
     /* Initial AddRoundKey with last round key */
-    add_round_key(block, rk + AES256_ROUNDS * 16);
+    add_round_key(block, drk);
 
     /* Rounds 13 down to 1 */
-    for (int r = AES256_ROUNDS - 1; r >= 1; r--) {
+    for (int r = 1; r < AES256_ROUNDS; r++) {
         inv_shift_rows(block);
         inv_sub_bytes(block);
-        add_round_key(block, rk + r * 16);
         inv_mix_columns(block);
+        add_round_key(block, drk + r * 16);
     }
 
     /* Final round (no InvMixColumns) */
     inv_shift_rows(block);
     inv_sub_bytes(block);
-    add_round_key(block, rk);
+    add_round_key(block, drk + AES256_ROUNDS * 16);
 }
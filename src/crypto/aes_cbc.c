@@ -1,28 +1,78 @@
 #include "usr/crypto.h"
+#include "aes_impl.h"
+#include "parallel.h"
 #include <string.h>
 #include <stdint.h>
 
 #define AES_BLOCK 16
-
-void usr_aes256_key_expand(const uint8_t key[32], uint8_t round_keys[240]);
-void usr_aes256_encrypt_block(uint8_t block[16], const uint8_t round_keys[240]);
-void usr_aes256_decrypt_block(uint8_t block[16], const uint8_t round_keys[240]);
+#define CBC_BATCH 32
 
 static inline void xor16(uint8_t *a, const uint8_t *b) {
     for (int i = 0; i < 16; i++) a[i] ^= b[i];
 }
 
+/* ============================================================
+   Block kernels, shared by the one-shot and streaming APIs.
+   `iv` is the chaining block and is advanced past the blocks.
+   ============================================================ */
+
+typedef struct {
+    const usr_aes_backend *be;
+    const uint8_t         *rk;    /* enc_rk or dec_rk */
+    uint8_t               *iv;
+} cbc_chain;
+
+/* Encryption is serial: C_i = E(P_i ^ C_{i-1}) */
+static void cbc_encrypt_blocks(void *arg, const uint8_t *in,
+                               uint8_t *out, size_t nblocks) {
+    cbc_chain *c = (cbc_chain *)arg;
+    uint8_t block[16];
+    memcpy(block, c->iv, 16);
+    for (size_t i = 0; i < nblocks; i++) {
+        xor16(block, in + i * AES_BLOCK);
+        c->be->encrypt(block, c->rk);
+        memcpy(out + i * AES_BLOCK, block, AES_BLOCK);
+    }
+    memcpy(c->iv, block, 16);
+}
+
+/* Decryption is not: P_i = D(C_i) ^ C_{i-1}. `in` must not overlap
+   `out` (the streaming layer passes a private copy). */
+static void cbc_decrypt_blocks(void *arg, const uint8_t *in,
+                               uint8_t *out, size_t nblocks) {
+    cbc_chain *c = (cbc_chain *)arg;
+    if (nblocks == 0) return;
+    c->be->decrypt_blocks(in, out, nblocks, c->rk);
+    xor16(out, c->iv);
+    for (size_t b = 1; b < nblocks; b++) {
+        xor16(out + b * AES_BLOCK, in + (b - 1) * AES_BLOCK);
+    }
+    memcpy(c->iv, in + (nblocks - 1) * AES_BLOCK, AES_BLOCK);
+}
+
+/* Check PKCS#7 padding on the final plaintext block; returns the
+   pad length or 0 if invalid. */
+static size_t cbc_pad_len(const uint8_t last[16]) {
+    uint8_t pad = last[AES_BLOCK - 1];
+    if (pad == 0 || pad > AES_BLOCK) return 0;
+    for (size_t i = AES_BLOCK - pad; i < AES_BLOCK; i++) {
+        if (last[i] != pad) return 0;
+    }
+    return pad;
+}
+
 /* ============================================================
    AES-256-CBC Encrypt with PKCS#7 padding
    ============================================================ */
 
-int usr_aes256_cbc_encrypt(
-    const uint8_t *in,  size_t in_len,
-    const uint8_t  key[32],
-    const uint8_t  iv[16],
-    uint8_t       *out, size_t *out_len
+int usr_aes256_cbc_encrypt_ctx(
+    const uint8_t        *in,  size_t in_len,
+    const usr_aes256_ctx *ctx,
+    const uint8_t         iv[16],
+    uint8_t              *out, size_t *out_len
 ) {
-    if (!key || !iv || !out_len) return -1;
+    if (!ctx || !iv || !out_len) return -1;
+    if (!in && in_len) return -1;
 
     /* Padded length: always add a full padding block if already aligned */
     size_t pad_len = AES_BLOCK - (in_len % AES_BLOCK);
@@ -34,45 +84,146 @@ int usr_aes256_cbc_encrypt(
     }
     if (*out_len < total) { *out_len = total; return -1; }
 
-    uint8_t round_keys[240];
-    usr_aes256_key_expand(key, round_keys);
-
-    uint8_t prev[16];
-    memcpy(prev, iv, 16);
-
-    /* Copy plaintext and apply PKCS#7 padding */
-    uint8_t padded[4096]; /* use heap for large inputs */
-    uint8_t *buf = padded;
-    if (total > sizeof(padded)) {
-        /* Can't stack-allocate; caller should use streaming API.
-           For now, handle inline with pointer arithmetic. */
-        memcpy(out, in, in_len);
-        uint8_t pad = (uint8_t)pad_len;
-        for (size_t i = 0; i < pad_len; i++) out[in_len + i] = pad;
-        buf = out;
-    } else {
-        memcpy(buf, in ? in : (const uint8_t *)"", in_len);
-        uint8_t pad = (uint8_t)pad_len;
-        for (size_t i = 0; i < pad_len; i++) buf[in_len + i] = pad;
-    }
+    uint8_t chain[16], last[16];
+    size_t  last_len = 0;
+    cbc_chain c = { usr_aes_backend_get(), ctx->enc_rk, chain };
+    memcpy(chain, iv, 16);
 
-    for (size_t i = 0; i < total; i += AES_BLOCK) {
-        uint8_t block[16];
-        memcpy(block, buf + i, AES_BLOCK);
-        xor16(block, prev);
-        usr_aes256_encrypt_block(block, round_keys);
-        memcpy(out + i, block, AES_BLOCK);
-        memcpy(prev, block, AES_BLOCK);
-    }
+    /* Whole blocks straight from `in` (in == out is fine), then the
+       tail plus padding as the final block */
+    usr_aes_stream_blocks(last, &last_len, in, in_len, out,
+                          in_len / AES_BLOCK, cbc_encrypt_blocks, &c);
+    memset(last + last_len, (int)pad_len, pad_len);
+    cbc_encrypt_blocks(&c, last, out + total - AES_BLOCK, 1);
 
+    memset(last, 0, sizeof(last));
     *out_len = total;
     return 0;
 }
 
 /* ============================================================
    AES-256-CBC Decrypt with PKCS#7 unpadding
+
+   P_i = D(C_i) ^ C_{i-1} has no serial dependency, so blocks are
+   decrypted CBC_BATCH at a time through the backend's bulk path and
+   chained afterwards. Inputs of at least CBC_PAR_MIN bytes are also
+   split into contiguous ranges, one per worker thread.
+   ============================================================ */
+
+#define CBC_PAR_MIN   (1u << 20)    /* 1 MiB before threads pay off */
+#define CBC_PAR_SLICE (256u << 10)  /* minimum bytes per thread */
+#define CBC_PAR_MAX   64
+
+/* Decrypt `nblocks` blocks; `iv` is the ciphertext block before `in`.
+   The ciphertext is copied before it is overwritten, so in == out
+   works. */
+static void cbc_decrypt_range(const usr_aes_backend *be, const uint8_t drk[240],
+                              const uint8_t *in, uint8_t *out, size_t nblocks,
+                              const uint8_t iv[16]) {
+    uint8_t chain[16], cbuf[CBC_BATCH * AES_BLOCK];
+    cbc_chain c = { be, drk, chain };
+    memcpy(chain, iv, 16);
+
+    while (nblocks > 0) {
+        size_t n = nblocks < CBC_BATCH ? nblocks : CBC_BATCH;
+
+        memcpy(cbuf, in, n * AES_BLOCK);
+        cbc_decrypt_blocks(&c, cbuf, out, n);
+
+        in      += n * AES_BLOCK;
+        out     += n * AES_BLOCK;
+        nblocks -= n;
+    }
+}
+
+typedef struct {
+    const usr_aes_backend *be;
+    const uint8_t         *drk;
+    const uint8_t         *in;
+    uint8_t               *out;
+    size_t                 nblocks;
+    size_t                 per_task;               /* blocks per range */
+    uint8_t                prev[CBC_PAR_MAX][16];  /* chaining block per range */
+} cbc_par_job;
+
+static void cbc_par_task(void *arg, size_t t) {
+    cbc_par_job *job = (cbc_par_job *)arg;
+    size_t first = t * job->per_task;
+    size_t n = job->nblocks - first < job->per_task ? job->nblocks - first : job->per_task;
+    cbc_decrypt_range(job->be, job->drk, job->in + first * AES_BLOCK,
+                      job->out + first * AES_BLOCK, n, job->prev[t]);
+}
+
+int usr_aes256_cbc_decrypt_ctx(
+    const uint8_t        *in,  size_t in_len,
+    const usr_aes256_ctx *ctx,
+    const uint8_t         iv[16],
+    uint8_t              *out, size_t *out_len
+) {
+    if (!in || !ctx || !iv || !out_len) return -1;
+    if (in_len == 0 || (in_len % AES_BLOCK) != 0) return -1;
+    if (!out) { *out_len = in_len; return 0; }
+    if (*out_len < in_len) { *out_len = in_len; return -1; }
+
+    const usr_aes_backend *be = usr_aes_backend_get();
+    size_t nblocks = in_len / AES_BLOCK;
+
+    size_t n_tasks = 1;
+    if (in_len >= CBC_PAR_MIN) {
+        n_tasks = in_len / CBC_PAR_SLICE;
+        size_t max_tasks = (size_t)usr_parallel_threads();
+        if (n_tasks > max_tasks)    n_tasks = max_tasks;
+        if (n_tasks > CBC_PAR_MAX)  n_tasks = CBC_PAR_MAX;
+    }
+
+    if (n_tasks <= 1) {
+        cbc_decrypt_range(be, ctx->dec_rk, in, out, nblocks, iv);
+    } else {
+        cbc_par_job job;
+        job.be       = be;
+        job.drk      = ctx->dec_rk;
+        job.in       = in;
+        job.out      = out;
+        job.nblocks  = nblocks;
+        job.per_task = (nblocks + n_tasks - 1) / n_tasks;
+        n_tasks      = (nblocks + job.per_task - 1) / job.per_task;
+
+        /* Capture each range's chaining block before any thread can
+           overwrite it (in-place decryption) */
+        memcpy(job.prev[0], iv, 16);
+        for (size_t t = 1; t < n_tasks; t++) {
+            memcpy(job.prev[t], in + (t * job.per_task - 1) * AES_BLOCK, AES_BLOCK);
+        }
+        usr_parallel_for(n_tasks, cbc_par_task, &job);
+    }
+
+    /* Verify and strip PKCS#7 padding (final block only) */
+    size_t pad = cbc_pad_len(out + in_len - AES_BLOCK);
+    if (pad == 0) return -1;
+
+    *out_len = in_len - pad;
+    return 0;
+}
+
+/* ============================================================
+   Raw-key wrappers: expand the key for a single message
    ============================================================ */
 
+int usr_aes256_cbc_encrypt(
+    const uint8_t *in,  size_t in_len,
+    const uint8_t  key[32],
+    const uint8_t  iv[16],
+    uint8_t       *out, size_t *out_len
+) {
+    if (!key || !iv || !out_len) return -1;
+
+    usr_aes256_ctx ctx;
+    usr_aes_backend_get()->key_expand(key, ctx.enc_rk);   /* dec_rk unused */
+    int r = usr_aes256_cbc_encrypt_ctx(in, in_len, &ctx, iv, out, out_len);
+    usr_aes256_wipe(&ctx);
+    return r;
+}
+
 int usr_aes256_cbc_decrypt(
     const uint8_t *in,  size_t in_len,
     const uint8_t  key[32],
@@ -80,32 +231,120 @@ int usr_aes256_cbc_decrypt(
     uint8_t       *out, size_t *out_len
 ) {
     if (!in || !key || !iv || !out_len) return -1;
-    if (in_len == 0 || (in_len % AES_BLOCK) != 0) return -1;
-    if (!out) { *out_len = in_len; return 0; }
-    if (*out_len < in_len) { *out_len = in_len; return -1; }
 
-    uint8_t round_keys[240];
-    usr_aes256_key_expand(key, round_keys);
+    usr_aes256_ctx ctx;
+    usr_aes256_init(&ctx, key);
+    int r = usr_aes256_cbc_decrypt_ctx(in, in_len, &ctx, iv, out, out_len);
+    usr_aes256_wipe(&ctx);
+    return r;
+}
+
+/* ============================================================
+   Streaming API
+   Encryption emits every completed block and keeps < 16 bytes;
+   decryption always holds back the last block until final() so
+   the padding can be checked there.
+   ============================================================ */
+
+static int cbc_stream_init(usr_aes256_cbc_ctx *ctx, const uint8_t key[32],
+                           const uint8_t iv[16], int decrypt) {
+    if (!ctx || !key || !iv) return -1;
+    if (decrypt) {
+        usr_aes256_init(&ctx->key, key);
+    } else {
+        usr_aes_backend_get()->key_expand(key, ctx->key.enc_rk);
+        memset(ctx->key.dec_rk, 0, sizeof(ctx->key.dec_rk));
+    }
+    memcpy(ctx->iv, iv, 16);
+    ctx->buflen = 0;
+    return 0;
+}
+
+int usr_aes256_cbc_encrypt_init(usr_aes256_cbc_ctx *ctx,
+                                const uint8_t key[32], const uint8_t iv[16]) {
+    return cbc_stream_init(ctx, key, iv, 0);
+}
 
-    uint8_t prev[16];
-    memcpy(prev, iv, 16);
+int usr_aes256_cbc_decrypt_init(usr_aes256_cbc_ctx *ctx,
+                                const uint8_t key[32], const uint8_t iv[16]) {
+    return cbc_stream_init(ctx, key, iv, 1);
+}
 
-    for (size_t i = 0; i < in_len; i += AES_BLOCK) {
-        uint8_t block[16];
-        memcpy(block, in + i, AES_BLOCK);
-        usr_aes256_decrypt_block(block, round_keys);
-        xor16(block, prev);
-        memcpy(out + i, block, AES_BLOCK);
-        memcpy(prev, in + i, AES_BLOCK);
+int usr_aes256_cbc_encrypt_update(
+    usr_aes256_cbc_ctx *ctx,
+    const uint8_t      *in,  size_t in_len,
+    uint8_t            *out, size_t *out_len
+) {
+    if (!ctx || !out_len || (!in && in_len)) return -1;
+
+    size_t nblocks = (ctx->buflen + in_len) / AES_BLOCK;
+    if (*out_len < nblocks * AES_BLOCK || (!out && nblocks)) {
+        *out_len = nblocks * AES_BLOCK;
+        return -1;
     }
 
-    /* Verify and strip PKCS#7 padding */
-    uint8_t pad = out[in_len - 1];
-    if (pad == 0 || pad > AES_BLOCK) return -1;
-    for (size_t i = in_len - pad; i < in_len; i++) {
-        if (out[i] != pad) return -1;
+    cbc_chain c = { usr_aes_backend_get(), ctx->key.enc_rk, ctx->iv };
+    usr_aes_stream_blocks(ctx->buf, &ctx->buflen, in, in_len, out, nblocks,
+                          cbc_encrypt_blocks, &c);
+    *out_len = nblocks * AES_BLOCK;
+    return 0;
+}
+
+int usr_aes256_cbc_encrypt_final(usr_aes256_cbc_ctx *ctx,
+                                 uint8_t *out, size_t *out_len) {
+    if (!ctx || !out_len) return -1;
+    if (!out || *out_len < AES_BLOCK) { *out_len = AES_BLOCK; return -1; }
+
+    uint8_t pad = (uint8_t)(AES_BLOCK - ctx->buflen);
+    memset(ctx->buf + ctx->buflen, pad, pad);
+
+    cbc_chain c = { usr_aes_backend_get(), ctx->key.enc_rk, ctx->iv };
+    cbc_encrypt_blocks(&c, ctx->buf, out, 1);
+
+    *out_len = AES_BLOCK;
+    memset(ctx, 0, sizeof(*ctx));
+    return 0;
+}
+
+int usr_aes256_cbc_decrypt_update(
+    usr_aes256_cbc_ctx *ctx,
+    const uint8_t      *in,  size_t in_len,
+    uint8_t            *out, size_t *out_len
+) {
+    if (!ctx || !out_len || (!in && in_len)) return -1;
+
+    size_t total   = ctx->buflen + in_len;
+    size_t nblocks = total ? (total - 1) / AES_BLOCK : 0;
+    if (*out_len < nblocks * AES_BLOCK || (!out && nblocks)) {
+        *out_len = nblocks * AES_BLOCK;
+        return -1;
     }
 
-    *out_len = in_len - pad;
+    cbc_chain c = { usr_aes_backend_get(), ctx->key.dec_rk, ctx->iv };
+    usr_aes_stream_blocks(ctx->buf, &ctx->buflen, in, in_len, out, nblocks,
+                          cbc_decrypt_blocks, &c);
+    *out_len = nblocks * AES_BLOCK;
+    return 0;
+}
+
+int usr_aes256_cbc_decrypt_final(usr_aes256_cbc_ctx *ctx,
+                                 uint8_t *out, size_t *out_len) {
+    if (!ctx || !out_len) return -1;
+    if (!out || *out_len < AES_BLOCK) { *out_len = AES_BLOCK; return -1; }
+
+    size_t pad = 0;
+    if (ctx->buflen == AES_BLOCK) {
+        cbc_chain c = { usr_aes_backend_get(), ctx->key.dec_rk, ctx->iv };
+        cbc_decrypt_blocks(&c, ctx->buf, out, 1);
+        pad = cbc_pad_len(out);
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    if (pad == 0) {
+        memset(out, 0, AES_BLOCK);
+        *out_len = 0;
+        return -1;
+    }
+    *out_len = AES_BLOCK - pad;
     return 0;
 }
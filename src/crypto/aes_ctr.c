@@ -1,10 +1,8 @@
 #include "usr/crypto.h"
+#include "aes_impl.h"
 #include <string.h>
 #include <stdint.h>
 
-void usr_aes256_key_expand(const uint8_t key[32], uint8_t round_keys[240]);
-void usr_aes256_encrypt_block(uint8_t block[16], const uint8_t round_keys[240]);
-
 /* ============================================================
    AES-256-CTR  (Encrypt = Decrypt, arbitrary length)
 
@@ -14,40 +12,112 @@ void usr_aes256_encrypt_block(uint8_t block[16], const uint8_t round_keys[240]);
 
    The caller may pass any 16-byte nonce; last 4 bytes are the counter.
    nonce[] is updated in-place to allow streaming across multiple calls.
+   usr_aes256_ctr_crypt_ex() widens the counter to 64 or 128 bits.
+
+   Counter blocks are independent, so keystream is produced CTR_BATCH
+   blocks at a time through the backend's bulk path and XORed in
+   64-bit words.
    ============================================================ */
 
-int usr_aes256_ctr_crypt(
-    uint8_t       *data,
-    size_t         len,
-    const uint8_t  key[32],
-    uint8_t        nonce[16]
+#define CTR_BATCH 32
+
+/* Increment the big-endian counter in the last `width` bytes */
+static inline void ctr_increment(uint8_t nonce[16], int width) {
+    for (int k = 15; k >= 16 - width; k--) {
+        if (++nonce[k]) break;
+    }
+}
+
+static inline uint32_t load32_be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8)  |  (uint32_t)p[3];
+}
+
+static inline void store32_be(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);  p[3] = (uint8_t)v;
+}
+
+static inline void xor_words(uint8_t *dst, const uint8_t *src, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t a, b;
+        memcpy(&a, dst + i, 8);
+        memcpy(&b, src + i, 8);
+        a ^= b;
+        memcpy(dst + i, &a, 8);
+    }
+    for (; i < n; i++) dst[i] ^= src[i];
+}
+
+int usr_aes256_ctr_crypt_ex(
+    uint8_t              *data,
+    size_t                len,
+    const usr_aes256_ctx *ctx,
+    uint8_t               nonce[16],
+    unsigned              counter_bits
 ) {
-    if (!data || !key || !nonce) return -1;
+    if (!data || !ctx || !nonce) return -1;
+    if (counter_bits != 32 && counter_bits != 64 && counter_bits != 128) return -1;
     if (len == 0) return 0;
 
-    uint8_t round_keys[240];
-    usr_aes256_key_expand(key, round_keys);
+    const usr_aes_backend *be = usr_aes_backend_get();
+    int width = (int)(counter_bits / 8);
 
-    uint8_t keystream[16];
+    uint8_t keystream[CTR_BATCH * 16];
     size_t  i = 0;
 
     while (i < len) {
-        /* Encrypt the current counter block to get keystream */
-        memcpy(keystream, nonce, 16);
-        usr_aes256_encrypt_block(keystream, round_keys);
-
-        /* XOR keystream with data (partial block at end) */
-        size_t chunk = (len - i < 16) ? (len - i) : 16;
-        for (size_t j = 0; j < chunk; j++) {
-            data[i + j] ^= keystream[j];
-        }
-        i += chunk;
+        size_t nblocks = (len - i + 15) / 16;
+        if (nblocks > CTR_BATCH) nblocks = CTR_BATCH;
 
-        /* Increment counter (big-endian, last 4 bytes) */
-        for (int k = 15; k >= 12; k--) {
-            if (++nonce[k]) break;
+        uint32_t lo = load32_be(nonce + 12);
+        if (width == 4 || lo <= UINT32_MAX - (uint32_t)nblocks) {
+            /* No carry out of the low word in this batch */
+            for (size_t b = 0; b < nblocks; b++) {
+                memcpy(keystream + 16 * b, nonce, 12);
+                store32_be(keystream + 16 * b + 12, lo + (uint32_t)b);
+            }
+            store32_be(nonce + 12, lo + (uint32_t)nblocks);
+        } else {
+            for (size_t b = 0; b < nblocks; b++) {
+                memcpy(keystream + 16 * b, nonce, 16);
+                ctr_increment(nonce, width);
+            }
         }
+        be->encrypt_blocks(keystream, keystream, nblocks, ctx->enc_rk);
+
+        /* A trailing partial block still consumes a counter value */
+        size_t chunk = (len - i < nblocks * 16) ? (len - i) : nblocks * 16;
+        xor_words(data + i, keystream, chunk);
+        i += chunk;
     }
 
+    memset(keystream, 0, sizeof(keystream));
     return 0;
 }
+
+int usr_aes256_ctr_crypt_ctx(
+    uint8_t              *data,
+    size_t                len,
+    const usr_aes256_ctx *ctx,
+    uint8_t               nonce[16]
+) {
+    return usr_aes256_ctr_crypt_ex(data, len, ctx, nonce, 32);
+}
+
+int usr_aes256_ctr_crypt(
+    uint8_t       *data,
+    size_t         len,
+    const uint8_t  key[32],
+    uint8_t        nonce[16]
+) {
+    if (!data || !key || !nonce) return -1;
+    if (len == 0) return 0;
+
+    usr_aes256_ctx ctx;
+    usr_aes_backend_get()->key_expand(key, ctx.enc_rk);   /* dec_rk unused */
+    int r = usr_aes256_ctr_crypt_ctx(data, len, &ctx, nonce);
+    usr_aes256_wipe(&ctx);
+    return r;
+}
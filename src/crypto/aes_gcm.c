@@ -0,0 +1,254 @@
+#include "usr/crypto.h"
+#include "aes_impl.h"
+#include "ghash.h"
+#include <string.h>
+#include <stdint.h>
+
+/* ============================================================
+   AES-256-GCM (NIST SP 800-38D)
+
+   Keystream comes from the CTR path (32-bit big-endian counter
+   starting at inc32(J0)); GHASH runs over the ciphertext of the same
+   chunk while it is still in cache, so each byte is touched once.
+
+   Partial blocks are carried in the context: `ks` holds unused
+   keystream and `buf` the AAD or ciphertext bytes that GHASH has not
+   yet absorbed (the two stay in step during the data phase).
+   ============================================================ */
+
+#define GCM_CHUNK      512                          /* bytes per fused CTR + GHASH step */
+#define GCM_MAX_DATA   ((1ULL << 36) - 32)          /* 2^39 - 256 bits */
+
+/* A wiped context reads as GCM_NONE and is rejected */
+enum { GCM_NONE = 0, GCM_AAD, GCM_DATA, GCM_DONE };
+
+static inline void store64_be(uint8_t *p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) { p[i] = (uint8_t)v; v >>= 8; }
+}
+
+static inline void gcm_ghash(usr_aes256_gcm_ctx *ctx, const uint8_t *in, size_t nblocks) {
+    usr_ghash_update(ctx->y, ctx->htable, ctx->hpow, in, nblocks);
+}
+
+/* Zero-pad and absorb whatever is left in buf */
+static void gcm_flush(usr_aes256_gcm_ctx *ctx) {
+    if (ctx->buflen) {
+        memset(ctx->buf + ctx->buflen, 0, 16 - ctx->buflen);
+        gcm_ghash(ctx, ctx->buf, 1);
+        ctx->buflen = 0;
+    }
+}
+
+int usr_aes256_gcm_init(usr_aes256_gcm_ctx *ctx, const uint8_t key[32],
+                        const uint8_t *iv, size_t iv_len) {
+    if (!ctx || !key || !iv || iv_len == 0) return -1;
+
+    const usr_aes_backend *be = usr_aes_backend_get();
+    uint8_t h[16] = {0};
+
+    memset(ctx, 0, sizeof(*ctx));
+    be->key_expand(key, ctx->key.enc_rk);
+    be->encrypt(h, ctx->key.enc_rk);
+    usr_ghash_setup(h, ctx->htable, ctx->hpow);
+    memset(h, 0, sizeof(h));
+
+    /* J0 = IV || 0^31 || 1 for 96-bit IVs, GHASH(IV || len) otherwise */
+    if (iv_len == 12) {
+        memcpy(ctx->ctr, iv, 12);
+        ctx->ctr[15] = 1;
+    } else {
+        uint8_t len_block[16] = {0};
+        size_t  full = iv_len / 16;
+        usr_ghash_update(ctx->ctr, ctx->htable, ctx->hpow, iv, full);
+        if (iv_len % 16) {
+            uint8_t last[16] = {0};
+            memcpy(last, iv + 16 * full, iv_len % 16);
+            usr_ghash_update(ctx->ctr, ctx->htable, ctx->hpow, last, 1);
+        }
+        store64_be(len_block + 8, (uint64_t)iv_len * 8);
+        usr_ghash_update(ctx->ctr, ctx->htable, ctx->hpow, len_block, 1);
+    }
+
+    /* E(J0) masks the tag; data starts at inc32(J0) */
+    memcpy(ctx->ek0, ctx->ctr, 16);
+    be->encrypt(ctx->ek0, ctx->key.enc_rk);
+    for (int k = 15; k >= 12; k--) {
+        if (++ctx->ctr[k]) break;
+    }
+
+    ctx->ks_used = 16;
+    ctx->phase   = GCM_AAD;
+    return 0;
+}
+
+int usr_aes256_gcm_aad(usr_aes256_gcm_ctx *ctx, const uint8_t *aad, size_t len) {
+    if (!ctx || (!aad && len)) return -1;
+    if (ctx->phase != GCM_AAD) return -1;
+    if (len == 0) return 0;
+
+    ctx->aad_len += len;
+
+    if (ctx->buflen) {
+        size_t take = 16 - ctx->buflen < len ? 16 - ctx->buflen : len;
+        memcpy(ctx->buf + ctx->buflen, aad, take);
+        ctx->buflen += take;
+        aad += take;
+        len -= take;
+        if (ctx->buflen < 16) return 0;
+        gcm_ghash(ctx, ctx->buf, 1);
+        ctx->buflen = 0;
+    }
+
+    gcm_ghash(ctx, aad, len / 16);
+    aad += len & ~(size_t)15;
+    len &= 15;
+
+    memcpy(ctx->buf, aad, len);
+    ctx->buflen = len;
+    return 0;
+}
+
+static int gcm_update(usr_aes256_gcm_ctx *ctx, const uint8_t *in,
+                      uint8_t *out, size_t len, int decrypt) {
+    if (!ctx || ((!in || !out) && len)) return -1;
+    if (ctx->phase == GCM_NONE || ctx->phase == GCM_DONE) return -1;
+    if (len > GCM_MAX_DATA - ctx->data_len) return -1;
+
+    if (ctx->phase == GCM_AAD) {
+        gcm_flush(ctx);
+        ctx->phase = GCM_DATA;
+    }
+    ctx->data_len += len;
+
+    for (;;) {
+        /* Use up buffered keystream a byte at a time */
+        while (ctx->ks_used < 16 && len) {
+            uint8_t c = decrypt ? *in : (uint8_t)(*in ^ ctx->ks[ctx->ks_used]);
+            *out = (uint8_t)(*in ^ ctx->ks[ctx->ks_used]);
+            ctx->buf[ctx->buflen++] = c;
+            ctx->ks_used++;
+            in++; out++; len--;
+            if (ctx->buflen == 16) {
+                gcm_ghash(ctx, ctx->buf, 1);
+                ctx->buflen = 0;
+            }
+        }
+
+        /* Whole blocks: CTR and GHASH one chunk at a time */
+        while (len >= 16) {
+            size_t chunk = len < GCM_CHUNK ? len & ~(size_t)15 : GCM_CHUNK;
+            if (decrypt) gcm_ghash(ctx, in, chunk / 16);
+            if (out != in) memcpy(out, in, chunk);
+            usr_aes256_ctr_crypt_ex(out, chunk, &ctx->key, ctx->ctr, 32);
+            if (!decrypt) gcm_ghash(ctx, out, chunk / 16);
+            in += chunk; out += chunk; len -= chunk;
+        }
+
+        if (len == 0) return 0;
+
+        /* Tail: one keystream block, consumed above on the next pass */
+        memset(ctx->ks, 0, 16);
+        usr_aes256_ctr_crypt_ex(ctx->ks, 16, &ctx->key, ctx->ctr, 32);
+        ctx->ks_used = 0;
+    }
+}
+
+int usr_aes256_gcm_encrypt_update(usr_aes256_gcm_ctx *ctx, const uint8_t *in,
+                                  uint8_t *out, size_t len) {
+    return gcm_update(ctx, in, out, len, 0);
+}
+
+int usr_aes256_gcm_decrypt_update(usr_aes256_gcm_ctx *ctx, const uint8_t *in,
+                                  uint8_t *out, size_t len) {
+    return gcm_update(ctx, in, out, len, 1);
+}
+
+/* Computes the full tag into `tag` and ends the message */
+static int gcm_tag(usr_aes256_gcm_ctx *ctx, uint8_t tag[16]) {
+    if (ctx->phase == GCM_NONE || ctx->phase == GCM_DONE) return -1;
+
+    uint8_t len_block[16];
+    gcm_flush(ctx);
+    store64_be(len_block,     ctx->aad_len * 8);
+    store64_be(len_block + 8, ctx->data_len * 8);
+    gcm_ghash(ctx, len_block, 1);
+
+    for (int i = 0; i < 16; i++) tag[i] = ctx->y[i] ^ ctx->ek0[i];
+    ctx->phase = GCM_DONE;
+    return 0;
+}
+
+int usr_aes256_gcm_encrypt_final(usr_aes256_gcm_ctx *ctx, uint8_t tag[16]) {
+    if (!ctx || !tag) return -1;
+    int r = gcm_tag(ctx, tag);
+    usr_aes256_gcm_wipe(ctx);
+    return r;
+}
+
+int usr_aes256_gcm_decrypt_final(usr_aes256_gcm_ctx *ctx,
+                                 const uint8_t *tag, size_t tag_len) {
+    if (!ctx || !tag || tag_len < 12 || tag_len > 16) {
+        usr_aes256_gcm_wipe(ctx);
+        return -1;
+    }
+
+    uint8_t expect[16];
+    int r = gcm_tag(ctx, expect);
+
+    /* Constant-time comparison */
+    uint8_t diff = 0;
+    for (size_t i = 0; i < tag_len; i++) diff |= expect[i] ^ tag[i];
+
+    memset(expect, 0, sizeof(expect));
+    usr_aes256_gcm_wipe(ctx);
+    return (r == 0 && diff == 0) ? 0 : -1;
+}
+
+void usr_aes256_gcm_wipe(usr_aes256_gcm_ctx *ctx) {
+    if (ctx) memset(ctx, 0, sizeof(*ctx));
+}
+
+/* ============================================================
+   One-shot API
+   ============================================================ */
+
+int usr_aes256_gcm_encrypt(
+    const uint8_t  key[32],
+    const uint8_t *iv,  size_t iv_len,
+    const uint8_t *aad, size_t aad_len,
+    const uint8_t *in,  size_t len,
+    uint8_t       *out,
+    uint8_t        tag[16]
+) {
+    usr_aes256_gcm_ctx ctx;
+    if (usr_aes256_gcm_init(&ctx, key, iv, iv_len) != 0) return -1;
+    if (usr_aes256_gcm_aad(&ctx, aad, aad_len) != 0 ||
+        usr_aes256_gcm_encrypt_update(&ctx, in, out, len) != 0) {
+        usr_aes256_gcm_wipe(&ctx);
+        return -1;
+    }
+    return usr_aes256_gcm_encrypt_final(&ctx, tag);
+}
+
+int usr_aes256_gcm_decrypt(
+    const uint8_t  key[32],
+    const uint8_t *iv,  size_t iv_len,
+    const uint8_t *aad, size_t aad_len,
+    const uint8_t *in,  size_t len,
+    uint8_t       *out,
+    const uint8_t *tag, size_t tag_len
+) {
+    usr_aes256_gcm_ctx ctx;
+    if (usr_aes256_gcm_init(&ctx, key, iv, iv_len) != 0) return -1;
+    if (usr_aes256_gcm_aad(&ctx, aad, aad_len) != 0 ||
+        usr_aes256_gcm_decrypt_update(&ctx, in, out, len) != 0) {
+        usr_aes256_gcm_wipe(&ctx);
+        return -1;
+    }
+    if (usr_aes256_gcm_decrypt_final(&ctx, tag, tag_len) != 0) {
+        /* Never release unauthenticated plaintext */
+        if (len) memset(out, 0, len);
+        return -1;
+    }
+    return 0;
+}
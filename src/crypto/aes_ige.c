@@ -1,14 +1,10 @@
 #include "usr/crypto.h"
+#include "aes_impl.h"
 #include <string.h>
 #include <stdint.h>
 
 #define AES_BLOCK 16
 
-/* Forward declarations */
-void usr_aes256_key_expand(const uint8_t key[32], uint8_t round_keys[240]);
-void usr_aes256_encrypt_block(uint8_t block[16], const uint8_t round_keys[240]);
-void usr_aes256_decrypt_block(uint8_t block[16], const uint8_t round_keys[240]);
-
 static inline void xor16(uint8_t *dst, const uint8_t *a, const uint8_t *b) {
     /* Unrolled 16-byte XOR — compiler will SIMD this with -O2 */
     dst[ 0] = a[ 0] ^ b[ 0]; dst[ 1] = a[ 1] ^ b[ 1];
@@ -32,46 +28,68 @@ static inline void xor16(uint8_t *dst, const uint8_t *a, const uint8_t *b) {
    iv[16..31] = previous ciphertext (C_{-1})
    ============================================================ */
 
-int usr_aes256_ige_encrypt(
-    uint8_t       *data,
-    size_t         len,
-    const uint8_t  key[32],
-    const uint8_t  iv[32]
-) {
-    if (!data || !key || !iv) return -1;
-    if (len == 0 || (len % AES_BLOCK) != 0) return -1;
-
-    uint8_t round_keys[240];
-    usr_aes256_key_expand(key, round_keys);
+/* Chaining state shared by the one-shot and streaming APIs */
+typedef struct {
+    const usr_aes_backend *be;
+    const uint8_t         *rk;            /* enc_rk or dec_rk */
+    uint8_t               *prev_plain;    /* P_{i-1} */
+    uint8_t               *prev_cipher;   /* C_{i-1} */
+} ige_chain;
 
-    uint8_t prev_plain[16];   /* P_{i-1} */
-    uint8_t prev_cipher[16];  /* C_{i-1} */
+/* `in` and `out` may be equal. The chaining values are kept in locals
+   so the compiler need not reload them through `arg` after each store. */
+static void ige_encrypt_blocks(void *arg, const uint8_t *in,
+                               uint8_t *out, size_t nblocks) {
+    ige_chain *c = (ige_chain *)arg;
+    const usr_aes_backend *be = c->be;
+    const uint8_t *rk = c->rk;
+    uint8_t prev_plain[16], prev_cipher[16];
 
-    /* iv[0..15]  = P_{-1},  iv[16..31] = C_{-1} */
-    memcpy(prev_plain,  iv,      16);
-    memcpy(prev_cipher, iv + 16, 16);
+    memcpy(prev_plain,  c->prev_plain,  16);
+    memcpy(prev_cipher, c->prev_cipher, 16);
 
-    for (size_t i = 0; i < len; i += AES_BLOCK) {
+    for (size_t i = 0; i < nblocks * AES_BLOCK; i += AES_BLOCK) {
         uint8_t block[16];
         uint8_t plain_save[16];
 
         /* Save P_i */
-        memcpy(plain_save, data + i, AES_BLOCK);
+        memcpy(plain_save, in + i, AES_BLOCK);
 
         /* block = P_i XOR C_{i-1} */
-        xor16(block, data + i, prev_cipher);
+        xor16(block, plain_save, prev_cipher);
 
         /* block = AES_enc(block) */
-        usr_aes256_encrypt_block(block, round_keys);
+        be->encrypt(block, rk);
 
         /* C_i = block XOR P_{i-1} */
-        xor16(data + i, block, prev_plain);
+        xor16(prev_cipher, block, prev_plain);
+        memcpy(out + i, prev_cipher, AES_BLOCK);
 
         /* Update chaining values */
-        memcpy(prev_plain,  plain_save, AES_BLOCK);
-        memcpy(prev_cipher, data + i,  AES_BLOCK);
+        memcpy(prev_plain, plain_save, AES_BLOCK);
     }
 
+    memcpy(c->prev_plain,  prev_plain,  16);
+    memcpy(c->prev_cipher, prev_cipher, 16);
+}
+
+int usr_aes256_ige_encrypt_ctx(
+    uint8_t              *data,
+    size_t                len,
+    const usr_aes256_ctx *ctx,
+    const uint8_t         iv[32]
+) {
+    if (!data || !ctx || !iv) return -1;
+    if (len == 0 || (len % AES_BLOCK) != 0) return -1;
+
+    uint8_t prev_plain[16], prev_cipher[16];
+    ige_chain c = { usr_aes_backend_get(), ctx->enc_rk, prev_plain, prev_cipher };
+
+    /* iv[0..15]  = P_{-1},  iv[16..31] = C_{-1} */
+    memcpy(prev_plain,  iv,      16);
+    memcpy(prev_cipher, iv + 16, 16);
+
+    ige_encrypt_blocks(&c, data, data, len / AES_BLOCK);
     return 0;
 }
 
@@ -80,6 +98,80 @@ int usr_aes256_ige_encrypt(
    P_i = AES_dec(C_i XOR P_{i-1}) XOR C_{i-1}
    ============================================================ */
 
+static void ige_decrypt_blocks(void *arg, const uint8_t *in,
+                               uint8_t *out, size_t nblocks) {
+    ige_chain *c = (ige_chain *)arg;
+    const usr_aes_backend *be = c->be;
+    const uint8_t *rk = c->rk;
+    uint8_t prev_plain[16], prev_cipher[16];
+
+    memcpy(prev_plain,  c->prev_plain,  16);
+    memcpy(prev_cipher, c->prev_cipher, 16);
+
+    for (size_t i = 0; i < nblocks * AES_BLOCK; i += AES_BLOCK) {
+        uint8_t block[16];
+        uint8_t cipher_save[16];
+
+        /* Save C_i */
+        memcpy(cipher_save, in + i, AES_BLOCK);
+
+        /* block = C_i XOR P_{i-1} */
+        xor16(block, cipher_save, prev_plain);
+
+        /* block = AES_dec(block) */
+        be->decrypt(block, rk);
+
+        /* P_i = block XOR C_{i-1} */
+        xor16(prev_plain, block, prev_cipher);
+        memcpy(out + i, prev_plain, AES_BLOCK);
+
+        /* Update chaining values */
+        memcpy(prev_cipher, cipher_save, AES_BLOCK);
+    }
+
+    memcpy(c->prev_plain,  prev_plain,  16);
+    memcpy(c->prev_cipher, prev_cipher, 16);
+}
+
+int usr_aes256_ige_decrypt_ctx(
+    uint8_t              *data,
+    size_t                len,
+    const usr_aes256_ctx *ctx,
+    const uint8_t         iv[32]
+) {
+    if (!data || !ctx || !iv) return -1;
+    if (len == 0 || (len % AES_BLOCK) != 0) return -1;
+
+    uint8_t prev_plain[16], prev_cipher[16];
+    ige_chain c = { usr_aes_backend_get(), ctx->dec_rk, prev_plain, prev_cipher };
+
+    memcpy(prev_plain,  iv,      16);
+    memcpy(prev_cipher, iv + 16, 16);
+
+    ige_decrypt_blocks(&c, data, data, len / AES_BLOCK);
+    return 0;
+}
+
+/* ============================================================
+   Raw-key wrappers: expand the key for a single message
+   ============================================================ */
+
+int usr_aes256_ige_encrypt(
+    uint8_t       *data,
+    size_t         len,
+    const uint8_t  key[32],
+    const uint8_t  iv[32]
+) {
+    if (!data || !key || !iv) return -1;
+    if (len == 0 || (len % AES_BLOCK) != 0) return -1;
+
+    usr_aes256_ctx ctx;
+    usr_aes_backend_get()->key_expand(key, ctx.enc_rk);   /* dec_rk unused */
+    int r = usr_aes256_ige_encrypt_ctx(data, len, &ctx, iv);
+    usr_aes256_wipe(&ctx);
+    return r;
+}
+
 int usr_aes256_ige_decrypt(
     uint8_t       *data,
     size_t         len,
@@ -89,35 +181,166 @@ int usr_aes256_ige_decrypt(
     if (!data || !key || !iv) return -1;
     if (len == 0 || (len % AES_BLOCK) != 0) return -1;
 
-    uint8_t round_keys[240];
-    usr_aes256_key_expand(key, round_keys);
+    usr_aes256_ctx ctx;
+    usr_aes256_init(&ctx, key);
+    int r = usr_aes256_ige_decrypt_ctx(data, len, &ctx, iv);
+    usr_aes256_wipe(&ctx);
+    return r;
+}
 
-    uint8_t prev_plain[16];   /* P_{i-1} */
-    uint8_t prev_cipher[16];  /* C_{i-1} */
+/* ============================================================
+   Multi-buffer IGE
+   Each message is serial, but different messages are not: up to
+   AES_MAX_LANES of them advance one block per step through the
+   backend's lane kernel. A lane that finishes takes the next job, so
+   messages of different lengths keep the lanes full.
+   ============================================================ */
 
-    memcpy(prev_plain,  iv,      16);
-    memcpy(prev_cipher, iv + 16, 16);
+static int ige_many(usr_aes256_ige_job *jobs, size_t n_jobs, int decrypt) {
+    if (!jobs && n_jobs) return -1;
+    for (size_t j = 0; j < n_jobs; j++) {
+        if (!jobs[j].data || !jobs[j].key || !jobs[j].iv) return -1;
+        if (jobs[j].len == 0 || (jobs[j].len % AES_BLOCK) != 0) return -1;
+    }
 
-    for (size_t i = 0; i < len; i += AES_BLOCK) {
-        uint8_t block[16];
-        uint8_t cipher_save[16];
+    const usr_aes_backend *be = usr_aes_backend_get();
+    void (*lanes_fn)(usr_aes_ige_lane *, size_t, size_t) =
+        decrypt ? be->ige_decrypt_lanes : be->ige_encrypt_lanes;
 
-        /* Save C_i */
-        memcpy(cipher_save, data + i, AES_BLOCK);
+    if (!lanes_fn) {
+        for (size_t j = 0; j < n_jobs; j++) {
+            if (decrypt) usr_aes256_ige_decrypt(jobs[j].data, jobs[j].len, jobs[j].key, jobs[j].iv);
+            else         usr_aes256_ige_encrypt(jobs[j].data, jobs[j].len, jobs[j].key, jobs[j].iv);
+        }
+        return 0;
+    }
 
-        /* block = C_i XOR P_{i-1} */
-        xor16(block, data + i, prev_plain);
+    uint8_t          sched[AES_MAX_LANES][240];
+    uint8_t          tmp[240];
+    usr_aes_ige_lane lane[AES_MAX_LANES];
+    size_t           left[AES_MAX_LANES];     /* blocks remaining per lane */
+    int              slot[AES_MAX_LANES];     /* schedule owned by each lane */
+    size_t           active = 0, next = 0;
 
-        /* block = AES_dec(block) */
-        usr_aes256_decrypt_block(block, round_keys);
+    for (int i = 0; i < AES_MAX_LANES; i++) slot[i] = i;
 
-        /* P_i = block XOR C_{i-1} */
-        xor16(data + i, block, prev_cipher);
+    for (;;) {
+        /* Refill: lanes [0, active) are live and packed */
+        while (active < AES_MAX_LANES && next < n_jobs) {
+            usr_aes256_ige_job *job = &jobs[next++];
+            usr_aes_ige_lane   *l   = &lane[active];
+            uint8_t            *rk  = sched[slot[active]];
 
-        /* Update chaining values */
-        memcpy(prev_plain,  data + i,    AES_BLOCK);
-        memcpy(prev_cipher, cipher_save, AES_BLOCK);
+            if (decrypt) {
+                be->key_expand(job->key, tmp);
+                be->invert_key(tmp, rk);
+            } else {
+                be->key_expand(job->key, rk);
+            }
+            l->data = job->data;
+            l->rk   = rk;
+            memcpy(l->prev_plain,  job->iv,      16);
+            memcpy(l->prev_cipher, job->iv + 16, 16);
+            left[active] = job->len / AES_BLOCK;
+            active++;
+        }
+        if (active == 0) break;
+
+        /* Run every lane until the shortest one finishes */
+        size_t step = left[0];
+        for (size_t i = 1; i < active; i++) {
+            if (left[i] < step) step = left[i];
+        }
+        lanes_fn(lane, active, step);
+
+        /* Retire finished lanes by swapping in the last live one */
+        for (size_t i = 0; i < active; ) {
+            left[i] -= step;
+            if (left[i] != 0) { i++; continue; }
+            active--;
+            if (i != active) {
+                int s = slot[i];
+                lane[i] = lane[active];
+                left[i] = left[active];   /* decremented on the next pass */
+                slot[i] = slot[active];
+                slot[active] = s;
+            }
+        }
+    }
+
+    memset(sched, 0, sizeof(sched));
+    memset(tmp, 0, sizeof(tmp));
+    memset(lane, 0, sizeof(lane));
+    return 0;
+}
+
+int usr_aes256_ige_encrypt_many(usr_aes256_ige_job *jobs, size_t n_jobs) {
+    return ige_many(jobs, n_jobs, 0);
+}
+
+int usr_aes256_ige_decrypt_many(usr_aes256_ige_job *jobs, size_t n_jobs) {
+    return ige_many(jobs, n_jobs, 1);
+}
+
+/* ============================================================
+   Streaming API
+   Chunks of any size; complete blocks are emitted immediately and
+   up to 15 bytes wait in the context for the next update().
+   ============================================================ */
+
+static int ige_stream_init(usr_aes256_ige_ctx *ctx, const uint8_t key[32],
+                           const uint8_t iv[32], int decrypt) {
+    if (!ctx || !key || !iv) return -1;
+    if (decrypt) {
+        usr_aes256_init(&ctx->key, key);
+    } else {
+        usr_aes_backend_get()->key_expand(key, ctx->key.enc_rk);
+        memset(ctx->key.dec_rk, 0, sizeof(ctx->key.dec_rk));
     }
+    memcpy(ctx->prev_plain,  iv,      16);
+    memcpy(ctx->prev_cipher, iv + 16, 16);
+    ctx->buflen  = 0;
+    ctx->decrypt = decrypt;
+    return 0;
+}
+
+int usr_aes256_ige_encrypt_init(usr_aes256_ige_ctx *ctx,
+                                const uint8_t key[32], const uint8_t iv[32]) {
+    return ige_stream_init(ctx, key, iv, 0);
+}
+
+int usr_aes256_ige_decrypt_init(usr_aes256_ige_ctx *ctx,
+                                const uint8_t key[32], const uint8_t iv[32]) {
+    return ige_stream_init(ctx, key, iv, 1);
+}
 
+int usr_aes256_ige_update(
+    usr_aes256_ige_ctx *ctx,
+    const uint8_t      *in,  size_t in_len,
+    uint8_t            *out, size_t *out_len
+) {
+    if (!ctx || !out_len || (!in && in_len)) return -1;
+
+    size_t nblocks = (ctx->buflen + in_len) / AES_BLOCK;
+    if (*out_len < nblocks * AES_BLOCK || (!out && nblocks)) {
+        *out_len = nblocks * AES_BLOCK;
+        return -1;
+    }
+
+    ige_chain c = {
+        usr_aes_backend_get(),
+        ctx->decrypt ? ctx->key.dec_rk : ctx->key.enc_rk,
+        ctx->prev_plain, ctx->prev_cipher
+    };
+    usr_aes_stream_blocks(ctx->buf, &ctx->buflen, in, in_len, out, nblocks,
+                          ctx->decrypt ? ige_decrypt_blocks : ige_encrypt_blocks, &c);
+    *out_len = nblocks * AES_BLOCK;
     return 0;
 }
+
+int usr_aes256_ige_final(usr_aes256_ige_ctx *ctx) {
+    if (!ctx) return -1;
+    int r = ctx->buflen == 0 ? 0 : -1;
+    memset(ctx, 0, sizeof(*ctx));
+    return r;
+}
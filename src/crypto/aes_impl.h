@@ -0,0 +1,95 @@
+#ifndef USR_AES_IMPL_H
+#define USR_AES_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "usr/crypto.h"
+
+/* AES-256: 14 rounds, 15 round keys (240 bytes) */
+#define AES256_ROUNDS 14
+
+/* ============================================================
+   AES block cipher backends
+
+   Every backend shares the same schedule formats:
+     rk[240]  — FIPS 197 encryption schedule, round 0 first
+     drk[240] — equivalent inverse cipher schedule (FIPS 197 §5.3.5):
+                drk[0] = rk[14], drk[r] = InvMixColumns(rk[14-r]),
+                drk[14] = rk[0]
+   so schedules can be computed by one backend and used by another.
+   ============================================================ */
+
+/* One message of a multi-buffer IGE batch. `data` is advanced past
+   the processed blocks, which are transformed in place. */
+typedef struct {
+    uint8_t       *data;
+    const uint8_t *rk;               /* enc_rk, or dec_rk for decryption */
+    uint8_t        prev_plain[16];   /* P_{i-1} */
+    uint8_t        prev_cipher[16];  /* C_{i-1} */
+} usr_aes_ige_lane;
+
+#define AES_MAX_LANES 8
+
+typedef struct {
+    usr_aes_impl id;
+    void (*key_expand)(const uint8_t key[32], uint8_t rk[240]);
+    void (*invert_key)(const uint8_t rk[240], uint8_t drk[240]);
+    void (*encrypt)(uint8_t block[16], const uint8_t rk[240]);
+    void (*decrypt)(uint8_t block[16], const uint8_t drk[240]);
+
+    /* Independent blocks (CTR keystream, CBC decryption). `in` and
+       `out` may be equal but must not otherwise overlap. */
+    void (*encrypt_blocks)(const uint8_t *in, uint8_t *out, size_t nblocks,
+                           const uint8_t rk[240]);
+    void (*decrypt_blocks)(const uint8_t *in, uint8_t *out, size_t nblocks,
+                           const uint8_t drk[240]);
+
+    /* Multi-buffer IGE (see usr_aes_ige_lane): advance each of `n`
+       lanes (n <= AES_MAX_LANES) by `nblocks` blocks in lockstep. NULL
+       when the backend gains nothing over serial per-message IGE. */
+    void (*ige_encrypt_lanes)(usr_aes_ige_lane *lanes, size_t n, size_t nblocks);
+    void (*ige_decrypt_lanes)(usr_aes_ige_lane *lanes, size_t n, size_t nblocks);
+} usr_aes_backend;
+
+/* Backend selected by usr_aes_set_impl() / CPU detection */
+const usr_aes_backend *usr_aes_backend_get(void);
+
+/* Byte-oriented reference code (aes_block.c, aes_block_decrypt.c) */
+void usr_aes_byte_key_expand(const uint8_t key[32], uint8_t rk[240]);
+void usr_aes_byte_invert_key(const uint8_t rk[240], uint8_t drk[240]);
+void usr_aes_byte_encrypt(uint8_t block[16], const uint8_t rk[240]);
+void usr_aes_byte_decrypt(uint8_t block[16], const uint8_t drk[240]);
+
+/* 32-bit T-table code (aes_ttable.c); shares the byte key schedule */
+void usr_aes_ttable_encrypt(uint8_t block[16], const uint8_t rk[240]);
+void usr_aes_ttable_decrypt(uint8_t block[16], const uint8_t drk[240]);
+
+/* Bitsliced constant-time code (aes_bitslice.c) */
+void usr_aes_bitslice_key_expand(const uint8_t key[32], uint8_t rk[240]);
+void usr_aes_bitslice_invert_key(const uint8_t rk[240], uint8_t drk[240]);
+void usr_aes_bitslice_encrypt(uint8_t block[16], const uint8_t rk[240]);
+void usr_aes_bitslice_decrypt(uint8_t block[16], const uint8_t drk[240]);
+void usr_aes_bitslice_encrypt_blocks(const uint8_t *in, uint8_t *out,
+                                     size_t nblocks, const uint8_t rk[240]);
+void usr_aes_bitslice_decrypt_blocks(const uint8_t *in, uint8_t *out,
+                                     size_t nblocks, const uint8_t drk[240]);
+
+/* Chained-mode streaming (aes_stream.c). Processes `nblocks` whole
+   blocks formed by the `*pending_len` carried bytes followed by `in`,
+   handing them to `fn` in batches, and leaves the remaining
+   pending_len + in_len - 16 * nblocks bytes (at most 16) in `pending`.
+   `out` may equal `in`. `fn` reads `nblocks` blocks from a private
+   buffer and writes them to `out`. */
+typedef void (*usr_aes_stream_fn)(void *arg, const uint8_t *in,
+                                  uint8_t *out, size_t nblocks);
+
+void usr_aes_stream_blocks(uint8_t pending[16], size_t *pending_len,
+                           const uint8_t *in, size_t in_len,
+                           uint8_t *out, size_t nblocks,
+                           usr_aes_stream_fn fn, void *arg);
+
+/* AES-NI (aes_ni.c); only usable when usr_cpu_has(USR_CPU_AESNI) */
+extern const usr_aes_backend usr_aes_backend_aesni;
+int usr_aesni_compiled(void);
+
+#endif /* USR_AES_IMPL_H */
@@ -0,0 +1,279 @@
+#include "aes_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+#include <string.h>
+
+/* ============================================================
+   AES-256 using the x86 AES-NI instructions
+   (AESENC / AESDEC / AESIMC / AESKEYGENASSIST).
+
+   Compiled with per-function target attributes so the rest of
+   the library stays baseline; only called when CPUID reports AES.
+   ============================================================ */
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define AESNI_TARGET USR_TARGET("aes,sse2")
+
+/* Expand the low half: w[i] = w[i-8] ^ RotWord/SubWord(w[i-1]) ^ rcon */
+AESNI_TARGET
+static inline __m128i expand_lo(__m128i lo, __m128i assist) {
+    assist = _mm_shuffle_epi32(assist, 0xFF);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(lo, 4));
+    lo = _mm_xor_si128(lo, _mm_slli_si128(lo, 4));
+    lo = _mm_xor_si128(lo, _mm_slli_si128(lo, 4));
+    return _mm_xor_si128(lo, assist);
+}
+
+/* Expand the high half: SubWord only, no rotation or rcon */
+AESNI_TARGET
+static inline __m128i expand_hi(__m128i lo, __m128i hi) {
+    __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(lo, 0x00), 0xAA);
+    hi = _mm_xor_si128(hi, _mm_slli_si128(hi, 4));
+    hi = _mm_xor_si128(hi, _mm_slli_si128(hi, 4));
+    hi = _mm_xor_si128(hi, _mm_slli_si128(hi, 4));
+    return _mm_xor_si128(hi, assist);
+}
+
+AESNI_TARGET
+static void aesni_key_expand(const uint8_t key[32], uint8_t rk[240]) {
+    __m128i lo = _mm_loadu_si128((const __m128i *)key);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(key + 16));
+    __m128i *out = (__m128i *)rk;
+
+    _mm_storeu_si128(out + 0, lo);
+    _mm_storeu_si128(out + 1, hi);
+
+/* AESKEYGENASSIST needs an immediate rcon, hence the macro */
+#define EXPAND_STEP(i, rcon) do {                                        \
+        lo = expand_lo(lo, _mm_aeskeygenassist_si128(hi, rcon));         \
+        _mm_storeu_si128(out + 2 * (i), lo);                             \
+        hi = expand_hi(lo, hi);                                          \
+        _mm_storeu_si128(out + 2 * (i) + 1, hi);                         \
+    } while (0)
+
+    EXPAND_STEP(1, 0x01);
+    EXPAND_STEP(2, 0x02);
+    EXPAND_STEP(3, 0x04);
+    EXPAND_STEP(4, 0x08);
+    EXPAND_STEP(5, 0x10);
+    EXPAND_STEP(6, 0x20);
+#undef EXPAND_STEP
+
+    lo = expand_lo(lo, _mm_aeskeygenassist_si128(hi, 0x40));
+    _mm_storeu_si128(out + 14, lo);
+}
+
+AESNI_TARGET
+static void aesni_invert_key(const uint8_t rk[240], uint8_t drk[240]) {
+    const __m128i *in = (const __m128i *)rk;
+    __m128i *out = (__m128i *)drk;
+
+    _mm_storeu_si128(out, _mm_loadu_si128(in + AES256_ROUNDS));
+    for (int r = 1; r < AES256_ROUNDS; r++) {
+        __m128i k = _mm_loadu_si128(in + AES256_ROUNDS - r);
+        _mm_storeu_si128(out + r, _mm_aesimc_si128(k));
+    }
+    _mm_storeu_si128(out + AES256_ROUNDS, _mm_loadu_si128(in));
+}
+
+AESNI_TARGET
+static void aesni_encrypt(uint8_t block[16], const uint8_t rk[240]) {
+    const __m128i *k = (const __m128i *)rk;
+    __m128i s = _mm_loadu_si128((const __m128i *)block);
+
+    s = _mm_xor_si128(s, _mm_loadu_si128(k));
+    for (int r = 1; r < AES256_ROUNDS; r++) {
+        s = _mm_aesenc_si128(s, _mm_loadu_si128(k + r));
+    }
+    s = _mm_aesenclast_si128(s, _mm_loadu_si128(k + AES256_ROUNDS));
+
+    _mm_storeu_si128((__m128i *)block, s);
+}
+
+AESNI_TARGET
+static void aesni_decrypt(uint8_t block[16], const uint8_t drk[240]) {
+    const __m128i *k = (const __m128i *)drk;
+    __m128i s = _mm_loadu_si128((const __m128i *)block);
+
+    s = _mm_xor_si128(s, _mm_loadu_si128(k));
+    for (int r = 1; r < AES256_ROUNDS; r++) {
+        s = _mm_aesdec_si128(s, _mm_loadu_si128(k + r));
+    }
+    s = _mm_aesdeclast_si128(s, _mm_loadu_si128(k + AES256_ROUNDS));
+
+    _mm_storeu_si128((__m128i *)block, s);
+}
+
+/* Bulk paths keep eight independent blocks in flight so that the
+   AESENC/AESDEC latency (several cycles) is hidden behind throughput. */
+#define AESNI_WAY 8
+
+AESNI_TARGET
+static void aesni_encrypt_blocks(const uint8_t *in, uint8_t *out,
+                                 size_t nblocks, const uint8_t rk[240]) {
+    const __m128i *k = (const __m128i *)rk;
+    const __m128i *src = (const __m128i *)in;
+    __m128i *dst = (__m128i *)out;
+
+    for (; nblocks >= AESNI_WAY; nblocks -= AESNI_WAY) {
+        __m128i s[AESNI_WAY];
+        __m128i k0 = _mm_loadu_si128(k);
+        for (int i = 0; i < AESNI_WAY; i++) {
+            s[i] = _mm_xor_si128(_mm_loadu_si128(src + i), k0);
+        }
+        for (int r = 1; r < AES256_ROUNDS; r++) {
+            __m128i kr = _mm_loadu_si128(k + r);
+            for (int i = 0; i < AESNI_WAY; i++) s[i] = _mm_aesenc_si128(s[i], kr);
+        }
+        __m128i kl = _mm_loadu_si128(k + AES256_ROUNDS);
+        for (int i = 0; i < AESNI_WAY; i++) {
+            _mm_storeu_si128(dst + i, _mm_aesenclast_si128(s[i], kl));
+        }
+        src += AESNI_WAY;
+        dst += AESNI_WAY;
+    }
+
+    for (; nblocks > 0; nblocks--) {
+        __m128i s = _mm_loadu_si128(src++);
+        s = _mm_xor_si128(s, _mm_loadu_si128(k));
+        for (int r = 1; r < AES256_ROUNDS; r++) {
+            s = _mm_aesenc_si128(s, _mm_loadu_si128(k + r));
+        }
+        _mm_storeu_si128(dst++, _mm_aesenclast_si128(s, _mm_loadu_si128(k + AES256_ROUNDS)));
+    }
+}
+
+AESNI_TARGET
+static void aesni_decrypt_blocks(const uint8_t *in, uint8_t *out,
+                                 size_t nblocks, const uint8_t drk[240]) {
+    const __m128i *k = (const __m128i *)drk;
+    const __m128i *src = (const __m128i *)in;
+    __m128i *dst = (__m128i *)out;
+
+    for (; nblocks >= AESNI_WAY; nblocks -= AESNI_WAY) {
+        __m128i s[AESNI_WAY];
+        __m128i k0 = _mm_loadu_si128(k);
+        for (int i = 0; i < AESNI_WAY; i++) {
+            s[i] = _mm_xor_si128(_mm_loadu_si128(src + i), k0);
+        }
+        for (int r = 1; r < AES256_ROUNDS; r++) {
+            __m128i kr = _mm_loadu_si128(k + r);
+            for (int i = 0; i < AESNI_WAY; i++) s[i] = _mm_aesdec_si128(s[i], kr);
+        }
+        __m128i kl = _mm_loadu_si128(k + AES256_ROUNDS);
+        for (int i = 0; i < AESNI_WAY; i++) {
+            _mm_storeu_si128(dst + i, _mm_aesdeclast_si128(s[i], kl));
+        }
+        src += AESNI_WAY;
+        dst += AESNI_WAY;
+    }
+
+    for (; nblocks > 0; nblocks--) {
+        __m128i s = _mm_loadu_si128(src++);
+        s = _mm_xor_si128(s, _mm_loadu_si128(k));
+        for (int r = 1; r < AES256_ROUNDS; r++) {
+            s = _mm_aesdec_si128(s, _mm_loadu_si128(k + r));
+        }
+        _mm_storeu_si128(dst++, _mm_aesdeclast_si128(s, _mm_loadu_si128(k + AES256_ROUNDS)));
+    }
+}
+
+/* Multi-buffer IGE: one message per lane, each with its own key, so
+   the rounds of up to eight serial chains overlap. Chaining values stay
+   in registers for the whole run of `nblocks`. */
+AESNI_TARGET
+static void aesni_ige_lanes(usr_aes_ige_lane *lanes, size_t n, size_t nblocks,
+                            int decrypt) {
+    __m128i pp[AES_MAX_LANES], pc[AES_MAX_LANES], s[AES_MAX_LANES], x[AES_MAX_LANES];
+    const __m128i *k[AES_MAX_LANES];
+
+    for (size_t i = 0; i < n; i++) {
+        pp[i] = _mm_loadu_si128((const __m128i *)lanes[i].prev_plain);
+        pc[i] = _mm_loadu_si128((const __m128i *)lanes[i].prev_cipher);
+        k[i]  = (const __m128i *)lanes[i].rk;
+    }
+
+    for (size_t blk = 0; blk < nblocks; blk++) {
+        for (size_t i = 0; i < n; i++) {
+            x[i] = _mm_loadu_si128((const __m128i *)lanes[i].data + blk);
+            /* enc: E(P_i ^ C_{i-1}),  dec: D(C_i ^ P_{i-1}) */
+            s[i] = _mm_xor_si128(x[i], decrypt ? pp[i] : pc[i]);
+            s[i] = _mm_xor_si128(s[i], _mm_loadu_si128(k[i]));
+        }
+        if (decrypt) {
+            for (int r = 1; r < AES256_ROUNDS; r++) {
+                for (size_t i = 0; i < n; i++) {
+                    s[i] = _mm_aesdec_si128(s[i], _mm_loadu_si128(k[i] + r));
+                }
+            }
+            for (size_t i = 0; i < n; i++) {
+                s[i] = _mm_aesdeclast_si128(s[i], _mm_loadu_si128(k[i] + AES256_ROUNDS));
+                pp[i] = _mm_xor_si128(s[i], pc[i]);     /* P_i */
+                pc[i] = x[i];
+                _mm_storeu_si128((__m128i *)lanes[i].data + blk, pp[i]);
+            }
+        } else {
+            for (int r = 1; r < AES256_ROUNDS; r++) {
+                for (size_t i = 0; i < n; i++) {
+                    s[i] = _mm_aesenc_si128(s[i], _mm_loadu_si128(k[i] + r));
+                }
+            }
+            for (size_t i = 0; i < n; i++) {
+                s[i] = _mm_aesenclast_si128(s[i], _mm_loadu_si128(k[i] + AES256_ROUNDS));
+                pc[i] = _mm_xor_si128(s[i], pp[i]);     /* C_i */
+                pp[i] = x[i];
+                _mm_storeu_si128((__m128i *)lanes[i].data + blk, pc[i]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        _mm_storeu_si128((__m128i *)lanes[i].prev_plain,  pp[i]);
+        _mm_storeu_si128((__m128i *)lanes[i].prev_cipher, pc[i]);
+        lanes[i].data += nblocks * 16;
+    }
+}
+
+static void aesni_ige_encrypt_lanes(usr_aes_ige_lane *lanes, size_t n, size_t nblocks) {
+    aesni_ige_lanes(lanes, n, nblocks, 0);
+}
+
+static void aesni_ige_decrypt_lanes(usr_aes_ige_lane *lanes, size_t n, size_t nblocks) {
+    aesni_ige_lanes(lanes, n, nblocks, 1);
+}
+
+const usr_aes_backend usr_aes_backend_aesni = {
+    USR_AES_IMPL_AESNI,
+    aesni_key_expand,
+    aesni_invert_key,
+    aesni_encrypt,
+    aesni_decrypt,
+    aesni_encrypt_blocks,
+    aesni_decrypt_blocks,
+    aesni_ige_encrypt_lanes,
+    aesni_ige_decrypt_lanes
+};
+
+int usr_aesni_compiled(void) { return 1; }
+
+#else /* !USR_X86 */
+
+/* Never selected: usr_aesni_compiled() reports it as unavailable. */
+const usr_aes_backend usr_aes_backend_aesni = {
+    USR_AES_IMPL_AESNI,
+    usr_aes_byte_key_expand,
+    usr_aes_byte_invert_key,
+    usr_aes_byte_encrypt,
+    usr_aes_byte_decrypt,
+    usr_aes_bitslice_encrypt_blocks,
+    usr_aes_bitslice_decrypt_blocks,
+    NULL,
+    NULL
+};
+
+int usr_aesni_compiled(void) { return 0; }
+
+#endif
@@ -0,0 +1,62 @@
+#include "aes_impl.h"
+#include <stdint.h>
+#include <string.h>
+
+/* ============================================================
+   Block streaming for chained modes (CBC, IGE)
+
+   Output lags input by the `pending_len` bytes carried over from the
+   previous call, so with out == in, writing output block k clobbers
+   the first pending_len bytes of input block k+1 (and, on the last
+   batch, the start of the new tail). Each batch therefore copies its
+   input into a private buffer and saves the bytes it is about to
+   overwrite before calling `fn`.
+   ============================================================ */
+
+#define STREAM_BATCH 32
+
+void usr_aes_stream_blocks(
+    uint8_t              pending[16],
+    size_t              *pending_len,
+    const uint8_t       *in,
+    size_t               in_len,
+    uint8_t             *out,
+    size_t               nblocks,
+    usr_aes_stream_fn    fn,
+    void                *arg
+) {
+    uint8_t cbuf[STREAM_BATCH * 16];
+    uint8_t carry[16];
+    size_t  lag = *pending_len;
+    size_t  total = lag + in_len;
+
+    memcpy(carry, pending, lag);
+
+    for (size_t a = 0; a < nblocks; ) {
+        size_t n = nblocks - a < STREAM_BATCH ? nblocks - a : STREAM_BATCH;
+        size_t b = a + n;
+
+        /* Blocks [a, b) are carry ++ in[16a, 16b - lag) */
+        memcpy(cbuf, carry, lag);
+        memcpy(cbuf + lag, in + 16 * a, 16 * n - lag);
+
+        if (b < nblocks) {
+            memcpy(carry, in + 16 * b - lag, lag);
+        } else {
+            size_t tail = total - 16 * nblocks;
+            memcpy(pending, in + 16 * b - lag, tail);
+            *pending_len = tail;
+        }
+
+        fn(arg, cbuf, out + 16 * a, n);
+        a = b;
+    }
+
+    if (nblocks == 0) {
+        if (in_len) memcpy(pending + lag, in, in_len);
+        *pending_len = total;
+    }
+
+    memset(cbuf, 0, sizeof(cbuf));
+    memset(carry, 0, sizeof(carry));
+}
@@ -91,8 +91,13 @@ uint8_t mul11[256];
 uint8_t mul13[256];
 uint8_t mul14[256];
 
+uint32_t te0[256], te1[256], te2[256], te3[256];
+uint32_t td0[256], td1[256], td2[256], td3[256];
+
+#define ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
 /*
- * Called once to build GF multiply tables.
+ * Called once to build GF multiply and 32-bit round tables.
  * In single-threaded startup this is fine. For thread-safety wrap with a mutex or
  * use __attribute__((constructor)) to run before main.
  */
@@ -107,6 +112,20 @@ void usr_aes_tables_init(void) {
         mul13[i] = x8 ^ x4 ^ (uint8_t)i;
         mul14[i] = x8 ^ x4 ^ x2;
     }
+    for (int i = 0; i < 256; i++) {
+        uint8_t s  = sbox[i];
+        uint8_t si = inv_sbox[i];
+        uint32_t e = (uint32_t)mul2[s]
+                   | ((uint32_t)s << 8)
+                   | ((uint32_t)s << 16)
+                   | ((uint32_t)mul3[s] << 24);
+        uint32_t d = (uint32_t)mul14[si]
+                   | ((uint32_t)mul9[si]  << 8)
+                   | ((uint32_t)mul13[si] << 16)
+                   | ((uint32_t)mul11[si] << 24);
+        te0[i] = e; te1[i] = ROTL32(e, 8); te2[i] = ROTL32(e, 16); te3[i] = ROTL32(e, 24);
+        td0[i] = d; td1[i] = ROTL32(d, 8); td2[i] = ROTL32(d, 16); td3[i] = ROTL32(d, 24);
+    }
     _build_init_done = 1;
 }
 
@@ -14,6 +14,13 @@ extern uint8_t mul11[256];
 extern uint8_t mul13[256];
 extern uint8_t mul14[256];
 
+/* 32-bit round tables (little-endian column words), also filled by
+   usr_aes_tables_init(). te0[x] = column (2·S[x], S[x], S[x], 3·S[x]),
+   td0[x] = column (14·Si[x], 9·Si[x], 13·Si[x], 11·Si[x]); te1..te3 and
+   td1..td3 are byte rotations of those. */
+extern uint32_t te0[256], te1[256], te2[256], te3[256];
+extern uint32_t td0[256], td1[256], td2[256], td3[256];
+
 void usr_aes_tables_init(void);
 
 #endif /* USR_AES_TABLES_H */
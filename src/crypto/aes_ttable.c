@@ -0,0 +1,101 @@
+#include "aes_tables.h"
+#include "aes_impl.h"
+#include <stdint.h>
+
+/* ============================================================
+   AES-256 — 32-bit T-table implementation
+
+   Each round merges SubBytes, ShiftRows and MixColumns into four
+   table lookups per column: column j of the next state takes row r
+   from column (j + r) mod 4 of the current one. The state is kept
+   as four little-endian column words, so byte r of a word is row r.
+
+   Decryption uses the equivalent inverse cipher schedule (drk), for
+   which the Td tables fold InvSubBytes and InvMixColumns together.
+   ============================================================ */
+
+#define LOAD32(p)  ((uint32_t)(p)[0]         | ((uint32_t)(p)[1] << 8) | \
+                   ((uint32_t)(p)[2] << 16)  | ((uint32_t)(p)[3] << 24))
+
+#define STORE32(p, v) do {                 \
+        (p)[0] = (uint8_t)(v);             \
+        (p)[1] = (uint8_t)((v) >> 8);      \
+        (p)[2] = (uint8_t)((v) >> 16);     \
+        (p)[3] = (uint8_t)((v) >> 24);     \
+    } while (0)
+
+#define B0(x) ((x) & 0xFF)
+#define B1(x) (((x) >> 8) & 0xFF)
+#define B2(x) (((x) >> 16) & 0xFF)
+#define B3(x) ((x) >> 24)
+
+void usr_aes_ttable_encrypt(uint8_t block[16], const uint8_t rk[240]) {
+    usr_aes_tables_init();
+
+    uint32_t s0 = LOAD32(block)      ^ LOAD32(rk);
+    uint32_t s1 = LOAD32(block + 4)  ^ LOAD32(rk + 4);
+    uint32_t s2 = LOAD32(block + 8)  ^ LOAD32(rk + 8);
+    uint32_t s3 = LOAD32(block + 12) ^ LOAD32(rk + 12);
+
+    for (int r = 1; r < AES256_ROUNDS; r++) {
+        const uint8_t *k = rk + r * 16;
+        uint32_t t0 = te0[B0(s0)] ^ te1[B1(s1)] ^ te2[B2(s2)] ^ te3[B3(s3)] ^ LOAD32(k);
+        uint32_t t1 = te0[B0(s1)] ^ te1[B1(s2)] ^ te2[B2(s3)] ^ te3[B3(s0)] ^ LOAD32(k + 4);
+        uint32_t t2 = te0[B0(s2)] ^ te1[B1(s3)] ^ te2[B2(s0)] ^ te3[B3(s1)] ^ LOAD32(k + 8);
+        uint32_t t3 = te0[B0(s3)] ^ te1[B1(s0)] ^ te2[B2(s1)] ^ te3[B3(s2)] ^ LOAD32(k + 12);
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    /* Final round: SubBytes + ShiftRows only */
+    const uint8_t *k = rk + AES256_ROUNDS * 16;
+    uint32_t o0 = (uint32_t)sbox[B0(s0)] | ((uint32_t)sbox[B1(s1)] << 8)
+                | ((uint32_t)sbox[B2(s2)] << 16) | ((uint32_t)sbox[B3(s3)] << 24);
+    uint32_t o1 = (uint32_t)sbox[B0(s1)] | ((uint32_t)sbox[B1(s2)] << 8)
+                | ((uint32_t)sbox[B2(s3)] << 16) | ((uint32_t)sbox[B3(s0)] << 24);
+    uint32_t o2 = (uint32_t)sbox[B0(s2)] | ((uint32_t)sbox[B1(s3)] << 8)
+                | ((uint32_t)sbox[B2(s0)] << 16) | ((uint32_t)sbox[B3(s1)] << 24);
+    uint32_t o3 = (uint32_t)sbox[B0(s3)] | ((uint32_t)sbox[B1(s0)] << 8)
+                | ((uint32_t)sbox[B2(s1)] << 16) | ((uint32_t)sbox[B3(s2)] << 24);
+
+    o0 ^= LOAD32(k); o1 ^= LOAD32(k + 4); o2 ^= LOAD32(k + 8); o3 ^= LOAD32(k + 12);
+    STORE32(block, o0);
+    STORE32(block + 4, o1);
+    STORE32(block + 8, o2);
+    STORE32(block + 12, o3);
+}
+
+void usr_aes_ttable_decrypt(uint8_t block[16], const uint8_t drk[240]) {
+    usr_aes_tables_init();
+
+    uint32_t s0 = LOAD32(block)      ^ LOAD32(drk);
+    uint32_t s1 = LOAD32(block + 4)  ^ LOAD32(drk + 4);
+    uint32_t s2 = LOAD32(block + 8)  ^ LOAD32(drk + 8);
+    uint32_t s3 = LOAD32(block + 12) ^ LOAD32(drk + 12);
+
+    /* InvShiftRows: row r of column j comes from column (j - r) mod 4 */
+    for (int r = 1; r < AES256_ROUNDS; r++) {
+        const uint8_t *k = drk + r * 16;
+        uint32_t t0 = td0[B0(s0)] ^ td1[B1(s3)] ^ td2[B2(s2)] ^ td3[B3(s1)] ^ LOAD32(k);
+        uint32_t t1 = td0[B0(s1)] ^ td1[B1(s0)] ^ td2[B2(s3)] ^ td3[B3(s2)] ^ LOAD32(k + 4);
+        uint32_t t2 = td0[B0(s2)] ^ td1[B1(s1)] ^ td2[B2(s0)] ^ td3[B3(s3)] ^ LOAD32(k + 8);
+        uint32_t t3 = td0[B0(s3)] ^ td1[B1(s2)] ^ td2[B2(s1)] ^ td3[B3(s0)] ^ LOAD32(k + 12);
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    /* Final round: InvSubBytes + InvShiftRows only */
+    const uint8_t *k = drk + AES256_ROUNDS * 16;
+    uint32_t o0 = (uint32_t)inv_sbox[B0(s0)] | ((uint32_t)inv_sbox[B1(s3)] << 8)
+                | ((uint32_t)inv_sbox[B2(s2)] << 16) | ((uint32_t)inv_sbox[B3(s1)] << 24);
+    uint32_t o1 = (uint32_t)inv_sbox[B0(s1)] | ((uint32_t)inv_sbox[B1(s0)] << 8)
+                | ((uint32_t)inv_sbox[B2(s3)] << 16) | ((uint32_t)inv_sbox[B3(s2)] << 24);
+    uint32_t o2 = (uint32_t)inv_sbox[B0(s2)] | ((uint32_t)inv_sbox[B1(s1)] << 8)
+                | ((uint32_t)inv_sbox[B2(s0)] << 16) | ((uint32_t)inv_sbox[B3(s3)] << 24);
+    uint32_t o3 = (uint32_t)inv_sbox[B0(s3)] | ((uint32_t)inv_sbox[B1(s2)] << 8)
+                | ((uint32_t)inv_sbox[B2(s1)] << 16) | ((uint32_t)inv_sbox[B3(s0)] << 24);
+
+    o0 ^= LOAD32(k); o1 ^= LOAD32(k + 4); o2 ^= LOAD32(k + 8); o3 ^= LOAD32(k + 12);
+    STORE32(block, o0);
+    STORE32(block + 4, o1);
+    STORE32(block + 8, o2);
+    STORE32(block + 12, o3);
+}
@@ -0,0 +1,79 @@
+#include "cpu_features.h"
+#include <stdint.h>
+
+#if USR_X86
+#  include <cpuid.h>
+#endif
+
+/* ============================================================
+   CPUID-based feature detection
+   ============================================================ */
+
+static uint32_t _cpu_detected = 0;
+static uint32_t _cpu_disabled = 0;
+static int      _cpu_init     = 0;
+
+#if USR_X86
+static uint64_t read_xcr0(void) {
+    uint32_t lo, hi;
+    __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+}
+#endif
+
+static uint32_t detect_features(void) {
+    uint32_t f = 0;
+#if USR_X86
+    unsigned int a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d)) return 0;
+
+    if (d & (1u << 26)) f |= USR_CPU_SSE2;
+    if (c & (1u <<  9)) f |= USR_CPU_SSSE3;
+    if (c & (1u << 19)) f |= USR_CPU_SSE41;
+    if (c & (1u << 20)) f |= USR_CPU_SSE42;
+    if (c & (1u << 25)) f |= USR_CPU_AESNI;
+    if (c & (1u <<  1)) f |= USR_CPU_PCLMUL;
+
+    /* AVX state must also be enabled by the OS (XCR0 bits 1,2) */
+    int ymm_ok = 0, zmm_ok = 0;
+    if (c & (1u << 27)) {
+        uint64_t xcr0 = read_xcr0();
+        ymm_ok = (xcr0 & 0x06) == 0x06;
+        zmm_ok = (xcr0 & 0xE6) == 0xE6;
+    }
+    if (ymm_ok && (c & (1u << 28))) f |= USR_CPU_AVX;
+
+    if (__get_cpuid_max(0, 0) >= 7) {
+        __cpuid_count(7, 0, a, b, c, d);
+        if (ymm_ok && (b & (1u <<  5))) f |= USR_CPU_AVX2;
+        if (b & (1u <<  8))             f |= USR_CPU_BMI2;
+        if (b & (1u << 29))             f |= USR_CPU_SHA;
+        if (zmm_ok && (b & (1u << 16))) f |= USR_CPU_AVX512F;
+        if (zmm_ok && (b & (1u << 30))) f |= USR_CPU_AVX512BW;
+        if (zmm_ok && (b & (1u << 31))) f |= USR_CPU_AVX512VL;
+        if (ymm_ok && (c & (1u << 10))) f |= USR_CPU_VPCLMUL;
+    }
+#endif
+    return f;
+}
+
+static void cpu_init(void) {
+    if (_cpu_init) return;
+    _cpu_detected = detect_features();
+    _cpu_init = 1;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor))
+static void _cpu_auto_init(void) { cpu_init(); }
+#endif
+
+uint32_t usr_cpu_features(void) {
+    cpu_init();
+    return _cpu_detected & ~_cpu_disabled;
+}
+
+void usr_cpu_disable(uint32_t mask) {
+    cpu_init();
+    _cpu_disabled = mask;
+}
@@ -0,0 +1,28 @@
+#ifndef USR_CPU_FEATURES_H
+#define USR_CPU_FEATURES_H
+
+#include <stdint.h>
+#include "usr/crypto.h"
+
+/* ============================================================
+   Internal helpers for runtime CPU dispatch.
+
+   SIMD kernels are compiled with per-function target attributes
+   (no global -m flags needed), so a single portable library can
+   carry them and pick one at runtime via usr_cpu_features().
+   ============================================================ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#  define USR_X86 1
+#  define USR_TARGET(s) __attribute__((target(s)))
+#else
+#  define USR_X86 0
+#  define USR_TARGET(s)
+#endif
+
+static inline int usr_cpu_has(uint32_t features) {
+    return (usr_cpu_features() & features) == features;
+}
+
+#endif /* USR_CPU_FEATURES_H */
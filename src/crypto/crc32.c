@@ -1,47 +1,55 @@
 #include "usr/crypto.h"
+#include "crc_impl.h"
+#include "cpu_features.h"
+#include "parallel.h"
 #include <stdint.h>
 
-/* CRC-32 (IEEE 802.3 / zlib polynomial 0xEDB88320) lookup table */
-static const uint32_t crc32_table[256] = {
-    0x00000000,0x77073096,0xee0e612c,0x990951ba,0x076dc419,0x706af48f,0xe963a535,0x9e6495a3,
-    0x0edb8832,0x79dcb8a4,0xe0d5e91b,0x97d2d988,0x09b64c2b,0x7eb17cbf,0xe7b82d08,0x90bf1d9c,
-    0x1db71064,0x6ab020f2,0xf3b97148,0x84be41de,0x1adad47d,0x6ddde4eb,0xf4d4b551,0x83d385c7,
-    0x136c9856,0x646ba8c0,0xfd62f97a,0x8a65c9ec,0x14015c4f,0x63066cd9,0xfa0f3d63,0x8d080df5,
-    0x3b6e20c8,0x4c69105e,0xd56041e4,0xa2677172,0x3c03e4d1,0x4b04d447,0xd20d85fd,0xa50ab56b,
-    0x35b5a8fa,0x42b2986c,0xdbbbc9d6,0xacbcf940,0x32d86ce3,0x45df5c75,0xdcd60dcf,0xabd13d59,
-    0x26d930ac,0x51de003a,0xc8d75180,0xbfd06116,0x21b4f927,0x56b3c423,0xcfba9599,0xb8bda50f,
-    0x2802b89e,0x5f058808,0xc60cd9b2,0xb10be924,0x2f6f7c87,0x58684c11,0xc1611dab,0xb6662d3d,
-    0x76dc4190,0x01db7106,0x98d220bc,0xefd5102a,0x71b18589,0x06b6b51f,0x9fbfe4a5,0xe8b8d433,
-    0x7807c9a2,0x0f00f934,0x9609a88e,0xe10e9818,0x7f6a0dbb,0x086d3d2d,0x91646c97,0xe6635c01,
-    0x6b6b51f4,0x1c6c6162,0x856530d8,0xf262004e,0x6c0695ed,0x1b01a57b,0x8208f4c1,0xf50fc457,
-    0x65b0d9c6,0x12b7e950,0x8bbeb8ea,0xfcb9887c,0x62dd1ddf,0x15da2d49,0x8cd37cf3,0xfbd44c65,
-    0x4db26158,0x3ab551ce,0xa3bc0074,0xd4bb30e2,0x4adfa541,0x3dd895d7,0xa4d1c46d,0xd3d6f4fb,
-    0x4369e96a,0x346ed9fc,0xad678846,0xda60b8d0,0x44042d73,0x33031de5,0xaa0a4c5f,0xdd0d7cc9,
-    0x5005713c,0x270241aa,0xbe0b1010,0xc90c2086,0x5768b525,0x206f85b3,0xb966d409,0xce61e49f,
-    0x5edef90e,0x29d9c998,0xb0d09822,0xc7d7a8b4,0x59b33d17,0x2eb40d81,0xb7bd5c3b,0xc0ba6cad,
-    0xedb88320,0x9abfb3b6,0x03b6e20c,0x74b1d29a,0xead54739,0x9dd277af,0x04db2615,0x73dc1683,
-    0xe3630b12,0x94643b84,0x0d6d6a3e,0x7a6a5aa8,0xe40ecf0b,0x9309ff9d,0x0a00ae27,0x7d079eb1,
-    0xf00f9344,0x8708a3d2,0x1e01f268,0x6906c2fe,0xf762575d,0x806567cb,0x196c3671,0x6e6b06e7,
-    0xfed41b76,0x89d32be0,0x10da7a5a,0x67dd4acc,0xf9b9df6f,0x8ebeeff9,0x17b7be43,0x60b08ed5,
-    0xd6d6a3e8,0xa1d1937e,0x38d8c2c4,0x4fdff252,0xd1bb67f1,0xa6bc5767,0x3fb506dd,0x48b2364b,
-    0xd80d2bda,0xaf0a1b4c,0x36034af6,0x41047a60,0xdf60efc3,0xa8670955,0x316658ef,0x466b6879,
-    0xb40bbe37,0xc30c8ea1,0x5a05df1b,0x2d02ef8d,
-    /* Fill remaining 26 entries (256-230) */
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
-};
-
-/* Note: The above table is truncated. Build it at runtime for correctness. */
-static uint32_t _crc_table[256];
+/* ============================================================
+   CRC-32 (IEEE 802.3 / zlib, reflected polynomial 0xEDB88320)
+
+   Long runs fold 64 bytes per step with carry-less multiplication
+   (crc32_clmul.c) when the CPU has PCLMULQDQ, 256 with VPCLMULQDQ
+   and AVX-512; everything else goes
+   through slicing-by-16, which consumes 16 bytes per step with
+   sixteen independent table lookups.
+
+   Buffers of at least CRC_PAR_MIN bytes are split into contiguous
+   ranges, one per worker thread, and the range CRCs are merged with
+   usr_crc32_combine().
+   ============================================================ */
+
+#define CRC_POLY      0xEDB88320u
+#define CRC_PAR_MIN   (8u << 20)    /* 8 MiB before threads pay off */
+#define CRC_PAR_SLICE (2u << 20)    /* minimum bytes per thread */
+#define CRC_PAR_MAX   64
+
+/* _crc_table[k][b]: CRC of byte b followed by k zero bytes */
+static uint32_t _crc_table[16][256];
+/* _crc_x2n[k]: x^(2^k) mod P; the sequence repeats with period 32 */
+static uint32_t _crc_x2n[32];
 static int      _crc_init = 0;
 
+#define multmodp(a, b) usr_crc_multmodp((a), (b), CRC_POLY)
+
 static void build_crc_table(void) {
     if (_crc_init) return;
     for (uint32_t i = 0; i < 256; i++) {
         uint32_t c = i;
         for (int j = 0; j < 8; j++) {
-            c = (c >> 1) ^ (0xEDB88320u * (c & 1));
+            c = (c >> 1) ^ (CRC_POLY * (c & 1));
         }
-        _crc_table[i] = c;
+        _crc_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int k = 1; k < 16; k++) {
+            uint32_t c = _crc_table[k - 1][i];
+            _crc_table[k][i] = (c >> 8) ^ _crc_table[0][c & 0xFF];
+        }
+    }
+    uint32_t x = 1u << 30;      /* x^1 */
+    _crc_x2n[0] = x;
+    for (int k = 1; k < 32; k++) {
+        _crc_x2n[k] = x = multmodp(x, x);
     }
     _crc_init = 1;
 }
@@ -51,22 +59,125 @@ __attribute__((constructor))
 static void _crc_auto_init(void) { build_crc_table(); }
 #endif
 
+static inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Register-form CRC (not inverted) over `len` bytes */
+static uint32_t crc32_slice16(uint32_t crc, const uint8_t *p, size_t len) {
+    const uint32_t (*t)[256] = (const uint32_t (*)[256])_crc_table;
+
+    for (; len >= 16; len -= 16, p += 16) {
+        uint32_t a = crc ^ load32_le(p);
+        uint32_t b = load32_le(p + 4);
+        uint32_t c = load32_le(p + 8);
+        uint32_t d = load32_le(p + 12);
+        crc = t[15][a & 0xFF] ^ t[14][(a >> 8) & 0xFF] ^ t[13][(a >> 16) & 0xFF] ^ t[12][a >> 24]
+            ^ t[11][b & 0xFF] ^ t[10][(b >> 8) & 0xFF] ^ t[ 9][(b >> 16) & 0xFF] ^ t[ 8][b >> 24]
+            ^ t[ 7][c & 0xFF] ^ t[ 6][(c >> 8) & 0xFF] ^ t[ 5][(c >> 16) & 0xFF] ^ t[ 4][c >> 24]
+            ^ t[ 3][d & 0xFF] ^ t[ 2][(d >> 8) & 0xFF] ^ t[ 1][(d >> 16) & 0xFF] ^ t[ 0][d >> 24];
+    }
+    while (len--) {
+        crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+/* Serial CRC over one range */
+static uint32_t crc32_range(uint32_t crc, const uint8_t *data, size_t len) {
+    /* crc is the finished (inverted) CRC so far; work on the register */
+    crc = ~crc;
+    if (len >= CRC32_CLMUL_MIN && usr_crc32_clmul_compiled() &&
+        usr_cpu_has(USR_CPU_PCLMUL | USR_CPU_SSE41)) {
+        size_t n = len & ~(size_t)15;
+        if (n >= CRC32_VPCLMUL_MIN && usr_cpu_has(USR_CPU_VPCLMUL | USR_CPU_AVX512F)) {
+            crc = usr_crc32_vpclmul(crc, data, n);
+        } else {
+            crc = usr_crc32_clmul(crc, data, n);
+        }
+        data += n;
+        len  -= n;
+    }
+    return ~crc32_slice16(crc, data, len);
+}
+
+/* ============================================================
+   Combining CRCs (GF(2) polynomial arithmetic, as in zlib)
+
+   Appending len_b bytes multiplies the register by x^(8 len_b)
+   mod P, so crc(A || B) = crc_a * x^(8 len_b) mod P ^ crc_b. The
+   power comes from the x^(2^k) table by square-and-multiply; the
+   pre- and post-inversions of the two CRCs cancel out.
+   ============================================================ */
+
+/* x^(n * 2^k) mod P */
+static uint32_t x2nmodp(uint64_t n, unsigned k) {
+    uint32_t p = 1u << 31;      /* x^0 */
+    for (; n; n >>= 1, k++) {
+        if (n & 1) p = multmodp(_crc_x2n[k & 31], p);
+    }
+    return p;
+}
+
+uint32_t usr_crc32_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b) {
+    build_crc_table();
+    return multmodp(x2nmodp(len_b, 3), crc_a) ^ crc_b;
+}
+
+/* ============================================================
+   Threaded CRC over large buffers
+   ============================================================ */
+
+typedef struct {
+    const uint8_t *data;
+    size_t         len;
+    size_t         per_task;            /* bytes per range */
+    uint32_t       crc[CRC_PAR_MAX];    /* seed in, range CRC out */
+} crc_par_job;
+
+static void crc_par_task(void *arg, size_t t) {
+    crc_par_job *job = (crc_par_job *)arg;
+    size_t first = t * job->per_task;
+    size_t n = job->len - first < job->per_task ? job->len - first : job->per_task;
+    job->crc[t] = crc32_range(job->crc[t], job->data + first, n);
+}
+
 uint32_t usr_crc32_update(uint32_t crc, const uint8_t *data, size_t len) {
+    if (!data || len == 0) return crc;
     build_crc_table();
-    /* crc is the running CRC (bit-inverted from the "register" form) */
-    crc = ~crc;  /* undo the final inversion if chaining; but convention: start with 0 */
-    for (size_t i = 0; i < len; i++) {
-        crc = _crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    size_t n_tasks = 1;
+    if (len >= CRC_PAR_MIN) {
+        n_tasks = len / CRC_PAR_SLICE;
+        size_t max_tasks = (size_t)usr_parallel_threads();
+        if (n_tasks > max_tasks)   n_tasks = max_tasks;
+        if (n_tasks > CRC_PAR_MAX) n_tasks = CRC_PAR_MAX;
     }
-    return ~crc;
+    if (n_tasks <= 1) return crc32_range(crc, data, len);
+
+    crc_par_job job;
+    job.data     = data;
+    job.len      = len;
+    job.per_task = (len + n_tasks - 1) / n_tasks;
+    job.per_task = (job.per_task + 255) & ~(size_t)255;  /* keep ranges on the wide kernel */
+    n_tasks      = (len + job.per_task - 1) / job.per_task;
+
+    /* The first range continues the caller's CRC; the rest start fresh */
+    job.crc[0] = crc;
+    for (size_t t = 1; t < n_tasks; t++) job.crc[t] = 0;
+    usr_parallel_for(n_tasks, crc_par_task, &job);
+
+    /* All ranges but the last have the same length, so one shift serves them */
+    uint32_t shift = x2nmodp(job.per_task, 3);
+    crc = job.crc[0];
+    for (size_t t = 1; t + 1 < n_tasks; t++) {
+        crc = multmodp(shift, crc) ^ job.crc[t];
+    }
+    return usr_crc32_combine(crc, job.crc[n_tasks - 1],
+                             len - (n_tasks - 1) * job.per_task);
 }
 
 uint32_t usr_crc32(const uint8_t *data, size_t len) {
-    if (!data && len == 0) return 0xFFFFFFFFu ^ 0xFFFFFFFFu; /* CRC32("") = 0 */
-    build_crc_table();
-    uint32_t crc = 0xFFFFFFFFu;
-    for (size_t i = 0; i < len; i++) {
-        crc = _crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
-    }
-    return crc ^ 0xFFFFFFFFu;
+    return usr_crc32_update(0, data, len);
 }
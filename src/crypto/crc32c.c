@@ -0,0 +1,96 @@
+#include "usr/crypto.h"
+#include "crc_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+
+/* ============================================================
+   CRC-32C (Castagnoli, reflected polynomial 0x82F63B78)
+
+   The polynomial of iSCSI, SCTP, ext4 and most storage formats.
+   CPUs with SSE4.2 compute it directly (crc32c_sse42.c); everything
+   else goes through slicing-by-8.
+   ============================================================ */
+
+#define CRC32C_POLY 0x82F63B78u
+
+#define multmodp(a, b) usr_crc_multmodp((a), (b), CRC32C_POLY)
+
+/* _crc32c_table[k][b]: CRC of byte b followed by k zero bytes */
+static uint32_t _crc32c_table[8][256];
+/* _crc32c_x2n[k]: x^(2^k) mod P; the sequence repeats with period 32 */
+static uint32_t _crc32c_x2n[32];
+static int      _crc32c_init = 0;
+
+static void build_crc32c_table(void) {
+    if (_crc32c_init) return;
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int j = 0; j < 8; j++) {
+            c = (c >> 1) ^ (CRC32C_POLY * (c & 1));
+        }
+        _crc32c_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            uint32_t c = _crc32c_table[k - 1][i];
+            _crc32c_table[k][i] = (c >> 8) ^ _crc32c_table[0][c & 0xFF];
+        }
+    }
+    uint32_t x = 1u << 30;      /* x^1 */
+    _crc32c_x2n[0] = x;
+    for (int k = 1; k < 32; k++) {
+        _crc32c_x2n[k] = x = multmodp(x, x);
+    }
+    _crc32c_init = 1;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor))
+static void _crc32c_auto_init(void) { build_crc32c_table(); }
+#endif
+
+static inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Register-form CRC (not inverted) over `len` bytes */
+static uint32_t crc32c_slice8(uint32_t crc, const uint8_t *p, size_t len) {
+    const uint32_t (*t)[256] = (const uint32_t (*)[256])_crc32c_table;
+
+    for (; len >= 8; len -= 8, p += 8) {
+        uint32_t a = crc ^ load32_le(p);
+        uint32_t b = load32_le(p + 4);
+        crc = t[7][a & 0xFF] ^ t[6][(a >> 8) & 0xFF] ^ t[5][(a >> 16) & 0xFF] ^ t[4][a >> 24]
+            ^ t[3][b & 0xFF] ^ t[2][(b >> 8) & 0xFF] ^ t[1][(b >> 16) & 0xFF] ^ t[0][b >> 24];
+    }
+    while (len--) {
+        crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+uint32_t usr_crc32c_update(uint32_t crc, const uint8_t *data, size_t len) {
+    if (!data || len == 0) return crc;
+    build_crc32c_table();
+
+    if (usr_crc32c_sse42_compiled() && usr_cpu_has(USR_CPU_SSE42)) {
+        return ~usr_crc32c_sse42(~crc, data, len);
+    }
+    return ~crc32c_slice8(~crc, data, len);
+}
+
+uint32_t usr_crc32c(const uint8_t *data, size_t len) {
+    return usr_crc32c_update(0, data, len);
+}
+
+/* Same construction as usr_crc32_combine() (crc32.c) */
+uint32_t usr_crc32c_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b) {
+    build_crc32c_table();
+
+    uint32_t p = 1u << 31;      /* x^0 */
+    for (unsigned k = 3; len_b; len_b >>= 1, k++) {
+        if (len_b & 1) p = multmodp(_crc32c_x2n[k & 31], p);
+    }
+    return multmodp(p, crc_a) ^ crc_b;
+}
@@ -0,0 +1,48 @@
+#ifndef USR_CRC_IMPL_H
+#define USR_CRC_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+   Internal CRC kernels. All take and return the CRC register
+   (not the inverted, finished value).
+   ============================================================ */
+
+/* Shortest inputs worth each kernel's setup and final reduction */
+#define CRC32_CLMUL_MIN   64
+#define CRC32_VPCLMUL_MIN 512
+
+/* PCLMULQDQ folding (crc32_clmul.c): len >= 64 and a multiple of 16.
+   Only usable when usr_cpu_has(USR_CPU_PCLMUL | USR_CPU_SSE41) and
+   usr_crc32_clmul_compiled(). */
+uint32_t usr_crc32_clmul(uint32_t crc, const uint8_t *data, size_t len);
+int      usr_crc32_clmul_compiled(void);
+
+/* 512-bit VPCLMULQDQ folding, same file and contract but len >= 256.
+   Needs USR_CPU_VPCLMUL | USR_CPU_AVX512F as well. */
+uint32_t usr_crc32_vpclmul(uint32_t crc, const uint8_t *data, size_t len);
+
+/* CRC-32C with the SSE4.2 crc32 instruction (crc32c_sse42.c), any
+   length. Only usable when usr_cpu_has(USR_CPU_SSE42) and
+   usr_crc32c_sse42_compiled(). */
+uint32_t usr_crc32c_sse42(uint32_t crc, const uint8_t *data, size_t len);
+int      usr_crc32c_sse42_compiled(void);
+
+/* a * b mod P over GF(2), both reflected (x^0 in the top bit);
+   poly is the reflected polynomial. Used to shift a CRC register
+   across zero bytes when merging independently computed CRCs. */
+static inline uint32_t usr_crc_multmodp(uint32_t a, uint32_t b, uint32_t poly) {
+    uint32_t m = 1u << 31, p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b >> 1) ^ (poly * (b & 1));
+    }
+    return p;
+}
+
+#endif /* USR_CRC_IMPL_H */
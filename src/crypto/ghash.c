@@ -0,0 +1,216 @@
+#include "ghash.h"
+#include "cpu_features.h"
+#include <stdint.h>
+#include <string.h>
+
+static inline uint64_t load64_be(const uint8_t *p) {
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) |
+           ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+           ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+           ((uint64_t)p[6] << 8)  |  (uint64_t)p[7];
+}
+
+static inline void store64_be(uint8_t *p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) { p[i] = (uint8_t)v; v >>= 8; }
+}
+
+/* ============================================================
+   Portable path: Shoup's 4-bit tables
+   HL/HH[i] = i * H for every 4-bit i (GCM bit order); the product
+   is built a nibble at a time, reducing with last4[] on each shift.
+   ============================================================ */
+
+static const uint16_t last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+static void table_init(uint64_t htable[32], const uint8_t h[16]) {
+    uint64_t *hl = htable, *hh = htable + 16;
+    uint64_t vh = load64_be(h), vl = load64_be(h + 8);
+
+    hl[0] = hh[0] = 0;
+    hl[8] = vl;
+    hh[8] = vh;
+
+    /* Halve: 4 * H, 2 * H, 1 * H in GCM's reflected bit order */
+    for (int i = 4; i > 0; i >>= 1) {
+        uint64_t t = (vl & 1) * 0xe1000000u;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ (t << 32);
+        hl[i] = vl;
+        hh[i] = vh;
+    }
+    for (int i = 2; i <= 8; i *= 2) {
+        for (int j = 1; j < i; j++) {
+            hh[i + j] = hh[i] ^ hh[j];
+            hl[i + j] = hl[i] ^ hl[j];
+        }
+    }
+}
+
+/* x = x * H */
+static void table_mult(uint8_t x[16], const uint64_t htable[32]) {
+    const uint64_t *hl = htable, *hh = htable + 16;
+    uint8_t  lo = x[15] & 0x0f;
+    uint64_t zh = hh[lo], zl = hl[lo];
+
+    for (int i = 15; i >= 0; i--) {
+        uint8_t hi = x[i] >> 4;
+        lo = x[i] & 0x0f;
+
+        if (i != 15) {
+            uint8_t rem = (uint8_t)(zl & 0x0f);
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ ((uint64_t)last4[rem] << 48);
+            zh ^= hh[lo];
+            zl ^= hl[lo];
+        }
+
+        uint8_t rem = (uint8_t)(zl & 0x0f);
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ ((uint64_t)last4[rem] << 48);
+        zh ^= hh[hi];
+        zl ^= hl[hi];
+    }
+
+    store64_be(x, zh);
+    store64_be(x + 8, zl);
+}
+
+static void ghash_table(uint8_t y[16], const uint64_t htable[32],
+                        const uint8_t *in, size_t nblocks) {
+    for (size_t b = 0; b < nblocks; b++) {
+        for (int i = 0; i < 16; i++) y[i] ^= in[16 * b + i];
+        table_mult(y, htable);
+    }
+}
+
+void usr_ghash_setup(const uint8_t h[16], uint64_t htable[32], uint8_t hpow[64]) {
+    table_init(htable, h);
+
+    /* H^(k+1) = H^k * H */
+    memcpy(hpow, h, 16);
+    for (int k = 1; k < 4; k++) {
+        memcpy(hpow + 16 * k, hpow + 16 * (k - 1), 16);
+        table_mult(hpow + 16 * k, htable);
+    }
+}
+
+/* ============================================================
+   PCLMULQDQ path
+   Operands are byte-reversed into little-endian order; the 256-bit
+   carry-less product is shifted left by one (GCM's bit reflection)
+   and reduced modulo x^128 + x^7 + x^2 + x + 1 (Intel CLMUL white
+   paper, algorithm 5). Four blocks are multiplied by H^4..H^1 and
+   summed before a single reduction.
+   ============================================================ */
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define CLMUL_TARGET USR_TARGET("pclmul,ssse3,sse2")
+
+/* Unreduced 256-bit product a * b as (lo, hi) */
+CLMUL_TARGET
+static inline void clmul_wide(__m128i a, __m128i b, __m128i *lo, __m128i *hi) {
+    __m128i t0 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t1 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t2 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x11);
+    t1 = _mm_xor_si128(t1, t2);
+    *lo = _mm_xor_si128(t0, _mm_slli_si128(t1, 8));
+    *hi = _mm_xor_si128(t3, _mm_srli_si128(t1, 8));
+}
+
+CLMUL_TARGET
+static inline __m128i clmul_reduce(__m128i lo, __m128i hi) {
+    /* Shift the 256-bit value left by one bit */
+    __m128i c_lo = _mm_srli_epi32(lo, 31);
+    __m128i c_hi = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i carry = _mm_srli_si128(c_lo, 12);
+    c_hi = _mm_slli_si128(c_hi, 4);
+    c_lo = _mm_slli_si128(c_lo, 4);
+    lo = _mm_or_si128(lo, c_lo);
+    hi = _mm_or_si128(hi, c_hi);
+    hi = _mm_or_si128(hi, carry);
+
+    /* First phase */
+    __m128i a = _mm_slli_epi32(lo, 31);
+    __m128i b = _mm_slli_epi32(lo, 30);
+    __m128i c = _mm_slli_epi32(lo, 25);
+    a = _mm_xor_si128(a, b);
+    a = _mm_xor_si128(a, c);
+    b = _mm_srli_si128(a, 4);
+    a = _mm_slli_si128(a, 12);
+    lo = _mm_xor_si128(lo, a);
+
+    /* Second phase */
+    __m128i d = _mm_srli_epi32(lo, 1);
+    __m128i e = _mm_srli_epi32(lo, 2);
+    __m128i f = _mm_srli_epi32(lo, 7);
+    d = _mm_xor_si128(d, e);
+    d = _mm_xor_si128(d, f);
+    d = _mm_xor_si128(d, b);
+    lo = _mm_xor_si128(lo, d);
+    return _mm_xor_si128(hi, lo);
+}
+
+CLMUL_TARGET
+static void ghash_clmul(uint8_t y[16], const uint8_t hpow[64],
+                        const uint8_t *in, size_t nblocks) {
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                       8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i h1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)hpow), bswap);
+    __m128i x  = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)y), bswap);
+    __m128i lo, hi, l, h;
+
+    if (nblocks >= 4) {
+        __m128i h2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(hpow + 16)), bswap);
+        __m128i h3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(hpow + 32)), bswap);
+        __m128i h4 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(hpow + 48)), bswap);
+
+        for (; nblocks >= 4; nblocks -= 4, in += 64) {
+            __m128i b0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in), bswap);
+            __m128i b1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + 16)), bswap);
+            __m128i b2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + 32)), bswap);
+            __m128i b3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + 48)), bswap);
+
+            /* (Y ^ B0) H^4 ^ B1 H^3 ^ B2 H^2 ^ B3 H */
+            clmul_wide(_mm_xor_si128(x, b0), h4, &lo, &hi);
+            clmul_wide(b1, h3, &l, &h);
+            lo = _mm_xor_si128(lo, l); hi = _mm_xor_si128(hi, h);
+            clmul_wide(b2, h2, &l, &h);
+            lo = _mm_xor_si128(lo, l); hi = _mm_xor_si128(hi, h);
+            clmul_wide(b3, h1, &l, &h);
+            lo = _mm_xor_si128(lo, l); hi = _mm_xor_si128(hi, h);
+            x = clmul_reduce(lo, hi);
+        }
+    }
+
+    for (; nblocks > 0; nblocks--, in += 16) {
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in), bswap);
+        clmul_wide(_mm_xor_si128(x, b), h1, &lo, &hi);
+        x = clmul_reduce(lo, hi);
+    }
+
+    _mm_storeu_si128((__m128i *)y, _mm_shuffle_epi8(x, bswap));
+}
+
+#endif /* USR_X86 */
+
+void usr_ghash_update(uint8_t y[16], const uint64_t htable[32], const uint8_t hpow[64],
+                      const uint8_t *in, size_t nblocks) {
+#if USR_X86
+    if (usr_cpu_has(USR_CPU_PCLMUL | USR_CPU_SSSE3)) {
+        ghash_clmul(y, hpow, in, nblocks);
+        return;
+    }
+#else
+    (void)hpow;
+#endif
+    ghash_table(y, htable, in, nblocks);
+}
@@ -0,0 +1,24 @@
+#ifndef USR_GHASH_H
+#define USR_GHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+   GHASH (GCM universal hash over GF(2^128))
+
+   usr_ghash_setup() derives both key forms from H = E(K, 0^128):
+     htable[32] — 4-bit Shoup tables (HL[16], HH[16]) for the
+                  portable path
+     hpow[64]   — H^1..H^4 in GCM byte order for the PCLMULQDQ
+                  path, which folds four blocks per reduction step
+   usr_ghash_update() absorbs whole 16-byte blocks into y and picks
+   the PCLMULQDQ kernel at runtime when the CPU has it.
+   ============================================================ */
+
+void usr_ghash_setup(const uint8_t h[16], uint64_t htable[32], uint8_t hpow[64]);
+
+void usr_ghash_update(uint8_t y[16], const uint64_t htable[32], const uint8_t hpow[64],
+                      const uint8_t *in, size_t nblocks);
+
+#endif /* USR_GHASH_H */
@@ -1,13 +1,19 @@
 #include "usr/crypto.h"
+#include "sha_impl.h"
 #include <string.h>
 #include <stdint.h>
 
 /* ============================================================
    HMAC-SHA256
    RFC 2104: HMAC = H((K XOR opad) || H((K XOR ipad) || message))
+   The key only enters through the first block of each hash, so
+   usr_hmac_sha256_key keeps both states after that block; a MAC
+   then costs the message blocks plus one outer compression.
    ============================================================ */
 
-void usr_hmac_sha256_init(usr_hmac_sha256_ctx *ctx,
+/* Inner and outer midstates: SHA-256 state after one block of
+   K ^ ipad / K ^ opad */
+static void hmac_key_setup(usr_hmac_sha256_key *hk,
                            const uint8_t *key, size_t key_len)
 {
     uint8_t k[64];
@@ -16,7 +22,7 @@ void usr_hmac_sha256_init(usr_hmac_sha256_ctx *ctx,
     /* If key > block size, hash it first */
     if (key_len > 64) {
         usr_sha256(key, key_len, k);
-    } else {
+    } else if (key_len) {
         memcpy(k, key, key_len);
     }
 
@@ -26,11 +32,82 @@ void usr_hmac_sha256_init(usr_hmac_sha256_ctx *ctx,
         opad[i] = k[i] ^ 0x5c;
     }
 
-    usr_sha256_init(&ctx->inner);
-    usr_sha256_update(&ctx->inner, ipad, 64);
+    usr_sha256_init(&hk->inner);
+    usr_sha256_compress(hk->inner.state, ipad, 1);
+    hk->inner.bitcount = 512;
+
+    usr_sha256_init(&hk->outer);
+    usr_sha256_compress(hk->outer.state, opad, 1);
+    hk->outer.bitcount = 512;
+
+    memset(k, 0, sizeof(k));
+    memset(ipad, 0, sizeof(ipad));
+    memset(opad, 0, sizeof(opad));
+}
+
+/* out = H(opad-block || inner_hash): the second block is fixed-size,
+   so pad it by hand and run a single compression */
+static void hmac_outer(const usr_sha256_ctx *outer,
+                       const uint8_t inner_hash[32], uint8_t out[32])
+{
+    uint32_t state[8];
+    uint8_t  block[64];
+
+    memcpy(state, outer->state, sizeof(state));
+    memcpy(block, inner_hash, 32);
+    block[32] = 0x80;
+    memset(block + 33, 0, 29);
+    block[62] = (uint8_t)((64 + 32) * 8 >> 8);    /* 768 bits */
+    block[63] = (uint8_t)((64 + 32) * 8);
+    usr_sha256_compress(state, block, 1);
 
-    usr_sha256_init(&ctx->outer);
-    usr_sha256_update(&ctx->outer, opad, 64);
+    for (int i = 0; i < 8; i++) {
+        out[i*4  ] = (uint8_t)(state[i] >> 24);
+        out[i*4+1] = (uint8_t)(state[i] >> 16);
+        out[i*4+2] = (uint8_t)(state[i] >>  8);
+        out[i*4+3] = (uint8_t)(state[i]      );
+    }
+    memset(state, 0, sizeof(state));
+}
+
+void usr_hmac_sha256_key_init(usr_hmac_sha256_key *hk,
+                              const uint8_t *key, size_t key_len)
+{
+    if (!hk || (!key && key_len)) return;
+    hmac_key_setup(hk, key, key_len);
+}
+
+void usr_hmac_sha256_key_wipe(usr_hmac_sha256_key *hk) {
+    if (hk) memset(hk, 0, sizeof(*hk));
+}
+
+void usr_hmac_sha256_start(usr_hmac_sha256_ctx *ctx,
+                           const usr_hmac_sha256_key *hk)
+{
+    ctx->inner = hk->inner;
+    ctx->outer = hk->outer;
+}
+
+void usr_hmac_sha256_keyed(const usr_hmac_sha256_key *hk,
+                           const uint8_t *data, size_t data_len,
+                           uint8_t out[32])
+{
+    usr_sha256_ctx inner = hk->inner;
+    uint8_t inner_hash[32];
+
+    usr_sha256_update(&inner, data, data_len);
+    usr_sha256_final(&inner, inner_hash);
+    hmac_outer(&hk->outer, inner_hash, out);
+    memset(inner_hash, 0, sizeof(inner_hash));
+}
+
+void usr_hmac_sha256_init(usr_hmac_sha256_ctx *ctx,
+                           const uint8_t *key, size_t key_len)
+{
+    usr_hmac_sha256_key hk;
+    hmac_key_setup(&hk, key, key_len);
+    usr_hmac_sha256_start(ctx, &hk);
+    usr_hmac_sha256_key_wipe(&hk);
 }
 
 void usr_hmac_sha256_update(usr_hmac_sha256_ctx *ctx,
@@ -42,8 +119,8 @@ void usr_hmac_sha256_update(usr_hmac_sha256_ctx *ctx,
 void usr_hmac_sha256_final(usr_hmac_sha256_ctx *ctx, uint8_t out[32]) {
     uint8_t inner_hash[32];
     usr_sha256_final(&ctx->inner, inner_hash);
-    usr_sha256_update(&ctx->outer, inner_hash, 32);
-    usr_sha256_final(&ctx->outer, out);
+    hmac_outer(&ctx->outer, inner_hash, out);
+    memset(&ctx->outer, 0, sizeof(ctx->outer));
     memset(inner_hash, 0, sizeof(inner_hash));
 }
 
@@ -51,59 +128,131 @@ void usr_hmac_sha256(const uint8_t *key, size_t key_len,
                      const uint8_t *data, size_t data_len,
                      uint8_t out[32])
 {
-    usr_hmac_sha256_ctx ctx;
-    usr_hmac_sha256_init(&ctx, key, key_len);
-    usr_hmac_sha256_update(&ctx, data, data_len);
-    usr_hmac_sha256_final(&ctx, out);
+    usr_hmac_sha256_key hk;
+    hmac_key_setup(&hk, key, key_len);
+    usr_hmac_sha256_keyed(&hk, data, data_len, out);
+    usr_hmac_sha256_key_wipe(&hk);
 }
 
 /* ============================================================
-   PBKDF2-HMAC-SHA256
-   RFC 2898 §5.2
+   HMAC-SHA512
+   Same construction over 128-byte blocks.
    ============================================================ */
 
-int usr_pbkdf2_sha256(
-    const uint8_t *password, size_t password_len,
-    const uint8_t *salt,     size_t salt_len,
-    uint32_t       iterations,
-    uint8_t       *out,      size_t out_len
-) {
-    if (!password || !salt || !out) return -1;
-    if (iterations == 0 || out_len == 0) return -1;
-
-    /* PBKDF2 block count */
-    size_t num_blocks = (out_len + 31) / 32;  /* ceil(out_len / hLen) */
-
-    for (size_t block = 1; block <= num_blocks; block++) {
-        uint8_t U[32], T[32];
-
-        /* U1 = HMAC(password, salt || INT(block)) */
-        uint8_t block_be[4] = {
-            (uint8_t)(block >> 24),
-            (uint8_t)(block >> 16),
-            (uint8_t)(block >>  8),
-            (uint8_t)(block      )
-        };
-
-        usr_hmac_sha256_ctx ctx;
-        usr_hmac_sha256_init(&ctx, password, password_len);
-        usr_hmac_sha256_update(&ctx, salt, salt_len);
-        usr_hmac_sha256_update(&ctx, block_be, 4);
-        usr_hmac_sha256_final(&ctx, U);
-
-        memcpy(T, U, 32);
-
-        /* Iterations 2..c */
-        for (uint32_t i = 1; i < iterations; i++) {
-            usr_hmac_sha256(password, password_len, U, 32, U);
-            for (int j = 0; j < 32; j++) T[j] ^= U[j];
-        }
+static void hmac512_key_setup(usr_hmac_sha512_key *hk,
+                              const uint8_t *key, size_t key_len)
+{
+    uint8_t k[128];
+    memset(k, 0, sizeof(k));
+
+    if (key_len > 128) {
+        usr_sha512(key, key_len, k);
+    } else if (key_len) {
+        memcpy(k, key, key_len);
+    }
+
+    uint8_t ipad[128], opad[128];
+    for (int i = 0; i < 128; i++) {
+        ipad[i] = k[i] ^ 0x36;
+        opad[i] = k[i] ^ 0x5c;
+    }
+
+    usr_sha512_init(&hk->inner);
+    usr_sha512_compress(hk->inner.state, ipad, 1);
+    hk->inner.bitcount_lo = 1024;
+
+    usr_sha512_init(&hk->outer);
+    usr_sha512_compress(hk->outer.state, opad, 1);
+    hk->outer.bitcount_lo = 1024;
+
+    memset(k, 0, sizeof(k));
+    memset(ipad, 0, sizeof(ipad));
+    memset(opad, 0, sizeof(opad));
+}
+
+/* out = H(opad-block || inner_hash) as one hand-padded compression */
+static void hmac512_outer(const usr_sha512_ctx *outer,
+                          const uint8_t inner_hash[64], uint8_t out[64])
+{
+    uint64_t state[8];
+    uint8_t  block[128];
 
-        /* Copy T to output (possibly partial for last block) */
-        size_t offset = (block - 1) * 32;
-        size_t copy   = (out_len - offset < 32) ? (out_len - offset) : 32;
-        memcpy(out + offset, T, copy);
+    memcpy(state, outer->state, sizeof(state));
+    memcpy(block, inner_hash, 64);
+    block[64] = 0x80;
+    memset(block + 65, 0, 61);
+    block[126] = (uint8_t)((128 + 64) * 8 >> 8);  /* 1536 bits */
+    block[127] = (uint8_t)((128 + 64) * 8);
+    usr_sha512_compress(state, block, 1);
+
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            out[i*8 + j] = (uint8_t)(state[i] >> (56 - 8 * j));
+        }
     }
+    memset(state, 0, sizeof(state));
+}
+
+void usr_hmac_sha512_key_init(usr_hmac_sha512_key *hk,
+                              const uint8_t *key, size_t key_len)
+{
+    if (!hk || (!key && key_len)) return;
+    hmac512_key_setup(hk, key, key_len);
+}
+
+void usr_hmac_sha512_key_wipe(usr_hmac_sha512_key *hk) {
+    if (hk) memset(hk, 0, sizeof(*hk));
+}
+
+void usr_hmac_sha512_start(usr_hmac_sha512_ctx *ctx,
+                           const usr_hmac_sha512_key *hk)
+{
+    ctx->inner = hk->inner;
+    ctx->outer = hk->outer;
+}
 
-    return 0;
+void usr_hmac_sha512_keyed(const usr_hmac_sha512_key *hk,
+                           const uint8_t *data, size_t data_len,
+                           uint8_t out[64])
+{
+    usr_sha512_ctx inner = hk->inner;
+    uint8_t inner_hash[64];
+
+    usr_sha512_update(&inner, data, data_len);
+    usr_sha512_final(&inner, inner_hash);
+    hmac512_outer(&hk->outer, inner_hash, out);
+    memset(inner_hash, 0, sizeof(inner_hash));
+}
+
+void usr_hmac_sha512_init(usr_hmac_sha512_ctx *ctx,
+                           const uint8_t *key, size_t key_len)
+{
+    usr_hmac_sha512_key hk;
+    hmac512_key_setup(&hk, key, key_len);
+    usr_hmac_sha512_start(ctx, &hk);
+    usr_hmac_sha512_key_wipe(&hk);
+}
+
+void usr_hmac_sha512_update(usr_hmac_sha512_ctx *ctx,
+                             const uint8_t *data, size_t len)
+{
+    usr_sha512_update(&ctx->inner, data, len);
+}
+
+void usr_hmac_sha512_final(usr_hmac_sha512_ctx *ctx, uint8_t out[64]) {
+    uint8_t inner_hash[64];
+    usr_sha512_final(&ctx->inner, inner_hash);
+    hmac512_outer(&ctx->outer, inner_hash, out);
+    memset(&ctx->outer, 0, sizeof(ctx->outer));
+    memset(inner_hash, 0, sizeof(inner_hash));
+}
+
+void usr_hmac_sha512(const uint8_t *key, size_t key_len,
+                     const uint8_t *data, size_t data_len,
+                     uint8_t out[64])
+{
+    usr_hmac_sha512_key hk;
+    hmac512_key_setup(&hk, key, key_len);
+    usr_hmac_sha512_keyed(&hk, data, data_len, out);
+    usr_hmac_sha512_key_wipe(&hk);
 }
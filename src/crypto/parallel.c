@@ -0,0 +1,86 @@
+#include "parallel.h"
+#include "usr/crypto.h"
+#include <stddef.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  define USR_HAVE_PTHREAD 1
+#  include <pthread.h>
+#  include <unistd.h>
+#else
+#  define USR_HAVE_PTHREAD 0
+#endif
+
+#define PARALLEL_MAX_TASKS 64
+
+static int _thread_limit = 0;   /* 0 = one per online CPU */
+
+void usr_crypto_set_threads(int n) {
+    _thread_limit = n < 0 ? 0 : n;
+}
+
+static int online_cpus(void) {
+#if USR_HAVE_PTHREAD && defined(_SC_NPROCESSORS_ONLN)
+    static int cached = 0;
+    if (!cached) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        cached = (n < 1) ? 1 : (n > PARALLEL_MAX_TASKS ? PARALLEL_MAX_TASKS : (int)n);
+    }
+    return cached;
+#else
+    return 1;
+#endif
+}
+
+int usr_parallel_threads(void) {
+#if USR_HAVE_PTHREAD
+    int n = _thread_limit ? _thread_limit : online_cpus();
+    return n > PARALLEL_MAX_TASKS ? PARALLEL_MAX_TASKS : n;
+#else
+    return 1;
+#endif
+}
+
+#if USR_HAVE_PTHREAD
+
+typedef struct {
+    usr_parallel_fn fn;
+    void           *arg;
+    size_t          index;
+} parallel_task;
+
+static void *parallel_entry(void *p) {
+    parallel_task *t = (parallel_task *)p;
+    t->fn(t->arg, t->index);
+    return NULL;
+}
+
+void usr_parallel_for(size_t n_tasks, usr_parallel_fn fn, void *arg) {
+    pthread_t     tid[PARALLEL_MAX_TASKS];
+    parallel_task task[PARALLEL_MAX_TASKS];
+    int           started[PARALLEL_MAX_TASKS];
+    size_t        n_threads = n_tasks < PARALLEL_MAX_TASKS ? n_tasks : PARALLEL_MAX_TASKS;
+
+    for (size_t i = 1; i < n_threads; i++) {
+        task[i].fn = fn;
+        task[i].arg = arg;
+        task[i].index = i;
+        started[i] = pthread_create(&tid[i], NULL, parallel_entry, &task[i]) == 0;
+    }
+
+    /* Caller takes task 0 and anything beyond the thread cap */
+    if (n_tasks > 0) fn(arg, 0);
+    for (size_t i = n_threads; i < n_tasks; i++) fn(arg, i);
+
+    for (size_t i = 1; i < n_threads; i++) {
+        if (started[i]) pthread_join(tid[i], NULL);
+        else            fn(arg, i);
+    }
+}
+
+#else /* !USR_HAVE_PTHREAD */
+
+void usr_parallel_for(size_t n_tasks, usr_parallel_fn fn, void *arg) {
+    for (size_t i = 0; i < n_tasks; i++) fn(arg, i);
+}
+
+#endif
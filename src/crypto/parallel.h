@@ -0,0 +1,22 @@
+#ifndef USR_PARALLEL_H
+#define USR_PARALLEL_H
+
+#include <stddef.h>
+
+/* ============================================================
+   Minimal fork/join helper for bulk crypto paths.
+   Task i runs fn(arg, i); the calling thread takes task 0 and
+   one worker thread is started for each remaining task. Falls
+   back to running everything on the caller when threads are
+   unavailable or cannot be created.
+   ============================================================ */
+
+typedef void (*usr_parallel_fn)(void *arg, size_t index);
+
+void usr_parallel_for(size_t n_tasks, usr_parallel_fn fn, void *arg);
+
+/* Upper bound on tasks worth creating: the usr_crypto_set_threads()
+   limit, or the number of online CPUs when that is 0. */
+int usr_parallel_threads(void);
+
+#endif /* USR_PARALLEL_H */
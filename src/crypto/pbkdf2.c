@@ -0,0 +1,605 @@
+#include "usr/crypto.h"
+#include "sha_impl.h"
+#include "parallel.h"
+#include <string.h>
+#include <stdint.h>
+
+/* ============================================================
+   PBKDF2-HMAC-SHA256 / PBKDF2-HMAC-SHA512
+   RFC 2898 §5.2
+
+   The password is keyed once (usr_hmac_sha256_key / _sha512_key).
+   Every later iteration is U = HMAC(P, U) with a digest-sized U,
+   so both of its compressions run on pre-padded blocks whose first
+   hLen bytes are the only thing that changes: two compressions per
+   iteration, no buffering and no per-iteration key setup.
+
+   Output blocks are independent; large requests spread them over
+   worker threads (usr_crypto_set_threads()). Batches of passwords
+   (usr_pbkdf2_*_many) run one chain per SIMD lane instead.
+   ============================================================ */
+
+#define PBKDF2_PAR_MIN_WORK  (1u << 14)   /* iterations x blocks before threading */
+
+/* A digest or midstate: 8 words of the hash's word size */
+typedef union {
+    uint32_t w32[8];
+    uint64_t w64[8];
+} hash_words;
+
+typedef union {
+    usr_hmac_sha256_key s256;
+    usr_hmac_sha512_key s512;
+} pbkdf2_key;
+
+typedef struct {
+    usr_sha256_lanes_fn k256;
+    usr_sha512_lanes_fn k512;
+} lane_kernel;
+
+/* The hash-specific pieces; everything else is shared */
+typedef struct {
+    size_t hlen;                    /* digest bytes (8 words) */
+    size_t ws;                      /* word size */
+    void (*key_init)(pbkdf2_key *hk, const uint8_t *pw, size_t pw_len);
+    void (*midstates)(const pbkdf2_key *hk, hash_words *im, hash_words *om);
+    /* U_1 = HMAC(P, S || INT(index)) */
+    void (*first)(const pbkdf2_key *hk, const uint8_t *salt, size_t salt_len,
+                  uint32_t index, hash_words *u);
+    /* t ^= U_2 .. U_{count+1}, starting from U_1 = u */
+    void (*chain)(const hash_words *im, const hash_words *om,
+                  const hash_words *u, hash_words *t, uint32_t count);
+    int  (*lanes)(lane_kernel *k);  /* lane count, 1 when serial is faster */
+} pbkdf2_hash;
+
+static inline void index_be(uint32_t index, uint8_t out[4]) {
+    out[0] = (uint8_t)(index >> 24); out[1] = (uint8_t)(index >> 16);
+    out[2] = (uint8_t)(index >>  8); out[3] = (uint8_t)(index      );
+}
+
+/* ---- SHA-256 ------------------------------------------------- */
+
+static inline void store_words_be(uint8_t *p, const uint32_t w[8]) {
+    for (int i = 0; i < 8; i++) {
+        p[i*4  ] = (uint8_t)(w[i] >> 24);
+        p[i*4+1] = (uint8_t)(w[i] >> 16);
+        p[i*4+2] = (uint8_t)(w[i] >>  8);
+        p[i*4+3] = (uint8_t)(w[i]      );
+    }
+}
+
+/* 32 bytes of message, then SHA-256 padding for a 96-byte total
+   (the 64-byte key block came first) */
+static void pad_block(uint8_t block[64]) {
+    memset(block + 32, 0, 32);
+    block[32] = 0x80;
+    block[62] = (uint8_t)((64 + 32) * 8 >> 8);
+    block[63] = (uint8_t)((64 + 32) * 8);
+}
+
+static void sha256_key_init(pbkdf2_key *hk, const uint8_t *pw, size_t pw_len) {
+    usr_hmac_sha256_key_init(&hk->s256, pw, pw_len);
+}
+
+static void sha256_midstates(const pbkdf2_key *hk, hash_words *im, hash_words *om) {
+    memcpy(im->w32, hk->s256.inner.state, 32);
+    memcpy(om->w32, hk->s256.outer.state, 32);
+}
+
+static void sha256_first(const pbkdf2_key *hk, const uint8_t *salt, size_t salt_len,
+                         uint32_t index, hash_words *u) {
+    uint8_t idx[4], mac[32];
+    usr_hmac_sha256_ctx ctx;
+
+    index_be(index, idx);
+    usr_hmac_sha256_start(&ctx, &hk->s256);
+    usr_hmac_sha256_update(&ctx, salt, salt_len);
+    usr_hmac_sha256_update(&ctx, idx, 4);
+    usr_hmac_sha256_final(&ctx, mac);
+    for (int i = 0; i < 8; i++) {
+        u->w32[i] = ((uint32_t)mac[i*4] << 24) | ((uint32_t)mac[i*4+1] << 16) |
+                    ((uint32_t)mac[i*4+2] << 8) | (uint32_t)mac[i*4+3];
+    }
+    memset(mac, 0, sizeof(mac));
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+/* U_i = H(opad-state, H(ipad-state, U_{i-1})) */
+static void sha256_chain(const hash_words *im, const hash_words *om,
+                         const hash_words *u, hash_words *t, uint32_t count) {
+    uint8_t  inner_blk[64], outer_blk[64];
+    uint32_t st[8];
+
+    store_words_be(inner_blk, u->w32);
+    pad_block(inner_blk);
+    pad_block(outer_blk);
+
+    for (uint32_t it = 0; it < count; it++) {
+        memcpy(st, im->w32, sizeof(st));
+        usr_sha256_compress(st, inner_blk, 1);
+        store_words_be(outer_blk, st);
+
+        memcpy(st, om->w32, sizeof(st));
+        usr_sha256_compress(st, outer_blk, 1);
+        store_words_be(inner_blk, st);
+
+        for (int i = 0; i < 8; i++) t->w32[i] ^= st[i];
+    }
+
+    memset(st, 0, sizeof(st));
+    memset(inner_blk, 0, sizeof(inner_blk));
+    memset(outer_blk, 0, sizeof(outer_blk));
+}
+
+static int sha256_lanes(lane_kernel *k) {
+    int lanes;
+    k->k256 = usr_sha256_lanes_select(&lanes);
+    k->k512 = NULL;
+    return lanes;
+}
+
+static const pbkdf2_hash hash_sha256 = {
+    32, 4,
+    sha256_key_init, sha256_midstates, sha256_first, sha256_chain, sha256_lanes
+};
+
+/* ---- SHA-512 ------------------------------------------------- */
+
+static inline void store_words64_be(uint8_t *p, const uint64_t w[8]) {
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            p[i*8 + j] = (uint8_t)(w[i] >> (56 - 8 * j));
+        }
+    }
+}
+
+/* 64 bytes of message, then SHA-512 padding for a 192-byte total */
+static void pad_block512(uint8_t block[128]) {
+    memset(block + 64, 0, 64);
+    block[64]  = 0x80;
+    block[126] = (uint8_t)((128 + 64) * 8 >> 8);
+    block[127] = (uint8_t)((128 + 64) * 8);
+}
+
+static void sha512_key_init(pbkdf2_key *hk, const uint8_t *pw, size_t pw_len) {
+    usr_hmac_sha512_key_init(&hk->s512, pw, pw_len);
+}
+
+static void sha512_midstates(const pbkdf2_key *hk, hash_words *im, hash_words *om) {
+    memcpy(im->w64, hk->s512.inner.state, 64);
+    memcpy(om->w64, hk->s512.outer.state, 64);
+}
+
+static void sha512_first(const pbkdf2_key *hk, const uint8_t *salt, size_t salt_len,
+                         uint32_t index, hash_words *u) {
+    uint8_t idx[4], mac[64];
+    usr_hmac_sha512_ctx ctx;
+
+    index_be(index, idx);
+    usr_hmac_sha512_start(&ctx, &hk->s512);
+    usr_hmac_sha512_update(&ctx, salt, salt_len);
+    usr_hmac_sha512_update(&ctx, idx, 4);
+    usr_hmac_sha512_final(&ctx, mac);
+    for (int i = 0; i < 8; i++) {
+        u->w64[i] = 0;
+        for (int j = 0; j < 8; j++) u->w64[i] = (u->w64[i] << 8) | mac[i*8 + j];
+    }
+    memset(mac, 0, sizeof(mac));
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+static void sha512_chain(const hash_words *im, const hash_words *om,
+                         const hash_words *u, hash_words *t, uint32_t count) {
+    uint8_t  inner_blk[128], outer_blk[128];
+    uint64_t st[8];
+
+    store_words64_be(inner_blk, u->w64);
+    pad_block512(inner_blk);
+    pad_block512(outer_blk);
+
+    for (uint32_t it = 0; it < count; it++) {
+        memcpy(st, im->w64, sizeof(st));
+        usr_sha512_compress(st, inner_blk, 1);
+        store_words64_be(outer_blk, st);
+
+        memcpy(st, om->w64, sizeof(st));
+        usr_sha512_compress(st, outer_blk, 1);
+        store_words64_be(inner_blk, st);
+
+        for (int i = 0; i < 8; i++) t->w64[i] ^= st[i];
+    }
+
+    memset(st, 0, sizeof(st));
+    memset(inner_blk, 0, sizeof(inner_blk));
+    memset(outer_blk, 0, sizeof(outer_blk));
+}
+
+static int sha512_lanes(lane_kernel *k) {
+    int lanes;
+    k->k256 = NULL;
+    k->k512 = usr_sha512_lanes_select(&lanes);
+    return lanes;
+}
+
+static const pbkdf2_hash hash_sha512 = {
+    64, 8,
+    sha512_key_init, sha512_midstates, sha512_first, sha512_chain, sha512_lanes
+};
+
+/* ---- One output block ---------------------------------------- */
+
+static void store_digest(const pbkdf2_hash *h, const hash_words *t,
+                         uint8_t *out, size_t len) {
+    uint8_t T[64];
+    if (h->ws == 4) store_words_be(T, t->w32);
+    else            store_words64_be(T, t->w64);
+    memcpy(out, T, len < h->hlen ? len : h->hlen);
+    memset(T, 0, sizeof(T));
+}
+
+/* T_index = U_1 ^ ... ^ U_c; writes min(len, hLen) bytes */
+static void pbkdf2_block(const pbkdf2_hash *h, const pbkdf2_key *hk,
+                         const uint8_t *salt, size_t salt_len,
+                         uint32_t index, uint32_t iterations,
+                         uint8_t *out, size_t len) {
+    hash_words im, om, u, t;
+
+    h->midstates(hk, &im, &om);
+    h->first(hk, salt, salt_len, index, &u);
+    t = u;
+    h->chain(&im, &om, &u, &t, iterations - 1);
+    store_digest(h, &t, out, len);
+
+    memset(&im, 0, sizeof(im));
+    memset(&om, 0, sizeof(om));
+    memset(&u, 0, sizeof(u));
+    memset(&t, 0, sizeof(t));
+}
+
+typedef struct {
+    const pbkdf2_hash *h;
+    const pbkdf2_key  *hk;
+    const uint8_t *salt;
+    size_t         salt_len;
+    uint32_t       iterations;
+    uint8_t       *out;
+    size_t         out_len;
+    size_t         n_blocks;
+    size_t         n_tasks;
+} pbkdf2_job;
+
+/* Task `index` derives blocks index, index + n_tasks, ... */
+static void pbkdf2_task(void *arg, size_t index) {
+    const pbkdf2_job *job = (const pbkdf2_job *)arg;
+
+    for (size_t b = index; b < job->n_blocks; b += job->n_tasks) {
+        size_t offset = b * job->h->hlen;
+        pbkdf2_block(job->h, job->hk, job->salt, job->salt_len, (uint32_t)(b + 1),
+                     job->iterations, job->out + offset, job->out_len - offset);
+    }
+}
+
+static int pbkdf2_run(const pbkdf2_hash *h,
+                      const uint8_t *password, size_t password_len,
+                      const uint8_t *salt,     size_t salt_len,
+                      uint32_t iterations, uint8_t *out, size_t out_len) {
+    if (!password || !salt || !out) return -1;
+    if (iterations == 0 || out_len == 0) return -1;
+    if ((uint64_t)(out_len - 1) / h->hlen >= 0xFFFFFFFFu) return -1;
+
+    pbkdf2_key hk;
+    h->key_init(&hk, password, password_len);
+
+    pbkdf2_job job;
+    job.h          = h;
+    job.hk         = &hk;
+    job.salt       = salt;
+    job.salt_len   = salt_len;
+    job.iterations = iterations;
+    job.out        = out;
+    job.out_len    = out_len;
+    job.n_blocks   = (out_len + h->hlen - 1) / h->hlen;  /* ceil(out_len / hLen) */
+    job.n_tasks    = 1;
+
+    if (job.n_blocks > 1 && (uint64_t)iterations * job.n_blocks >= PBKDF2_PAR_MIN_WORK) {
+        size_t threads = (size_t)usr_parallel_threads();
+        job.n_tasks = job.n_blocks < threads ? job.n_blocks : threads;
+    }
+
+    if (job.n_tasks > 1) usr_parallel_for(job.n_tasks, pbkdf2_task, &job);
+    else                 pbkdf2_task(&job, 0);
+
+    memset(&hk, 0, sizeof(hk));
+    return 0;
+}
+
+int usr_pbkdf2_sha256(
+    const uint8_t *password, size_t password_len,
+    const uint8_t *salt,     size_t salt_len,
+    uint32_t       iterations,
+    uint8_t       *out,      size_t out_len
+) {
+    return pbkdf2_run(&hash_sha256, password, password_len, salt, salt_len,
+                      iterations, out, out_len);
+}
+
+int usr_pbkdf2_sha512(
+    const uint8_t *password, size_t password_len,
+    const uint8_t *salt,     size_t salt_len,
+    uint32_t       iterations,
+    uint8_t       *out,      size_t out_len
+) {
+    return pbkdf2_run(&hash_sha512, password, password_len, salt, salt_len,
+                      iterations, out, out_len);
+}
+
+/* ============================================================
+   Batches: one PBKDF2 chain per SIMD lane
+
+   Every (job, output block) pair is a chain. Each lane holds one;
+   all lanes share the multi-lane compression kernel, so one step
+   advances every chain by an iteration. Lane state stays transposed
+   between steps: the inner hash of one compression is the message
+   of the next as is, and T ^= U is a flat XOR over all lanes.
+   Steps run in bursts up to the nearest chain end; a finished lane
+   takes the next chain. As in usr_sha256_many, once the chains run
+   out and fewer than half the lanes are live, the rest finish on
+   the single-stream path.
+   ============================================================ */
+
+#define LANE_ROW 64   /* one transposed word: 16 x 32-bit or 8 x 64-bit lanes */
+#define LANES_MAX 16
+
+typedef struct {
+    const pbkdf2_hash *h;
+    lane_kernel        k;
+    int                lanes;
+    size_t             row;       /* lanes * ws */
+
+    const usr_pbkdf2_job *jobs;
+    size_t             n_jobs;
+    size_t             next_job;  /* next chain: job next_job, block next_block */
+    size_t             next_block;
+
+    _Alignas(64) uint8_t im[8 * LANE_ROW];   /* inner midstates */
+    _Alignas(64) uint8_t om[8 * LANE_ROW];   /* outer midstates */
+    _Alignas(64) uint8_t st[8 * LANE_ROW];
+    _Alignas(64) uint8_t wt[16 * LANE_ROW];  /* rows 0..7: U; 8..15: padding */
+    _Alignas(64) uint8_t t[8 * LANE_ROW];
+
+    uint8_t  *out[LANES_MAX];    /* NULL when the lane is idle */
+    size_t    out_len[LANES_MAX];
+    uint32_t  left[LANES_MAX];   /* iterations still to run */
+} lane_set;
+
+static inline uint8_t *lane_word(const lane_set *ls, uint8_t *arr, int i, int l) {
+    return arr + (size_t)i * ls->row + (size_t)l * ls->h->ws;
+}
+
+static inline void *hw_word(const lane_set *ls, hash_words *w, int i) {
+    return ls->h->ws == 4 ? (void *)&w->w32[i] : (void *)&w->w64[i];
+}
+
+static void lane_put(lane_set *ls, uint8_t *arr, int l, hash_words *w) {
+    for (int i = 0; i < 8; i++) memcpy(lane_word(ls, arr, i, l), hw_word(ls, w, i), ls->h->ws);
+}
+
+static void lane_get(lane_set *ls, uint8_t *arr, int l, hash_words *w) {
+    for (int i = 0; i < 8; i++) memcpy(hw_word(ls, w, i), lane_word(ls, arr, i, l), ls->h->ws);
+}
+
+static inline void lanes_compress(lane_set *ls) {
+    if (ls->k.k256) ls->k.k256((uint32_t *)(void *)ls->st, (const uint32_t *)(void *)ls->wt);
+    else            ls->k.k512((uint64_t *)(void *)ls->st, (const uint64_t *)(void *)ls->wt);
+}
+
+/* Start the next chain in lane `l`; returns 0 when none are left */
+static int lane_start(lane_set *ls, int l) {
+    if (ls->next_job == ls->n_jobs) return 0;
+
+    const usr_pbkdf2_job *job = &ls->jobs[ls->next_job];
+    size_t b = ls->next_block;
+    size_t offset = b * ls->h->hlen;
+    pbkdf2_key hk;
+    hash_words im, om, u;
+
+    ls->h->key_init(&hk, job->password, job->password_len);
+    ls->h->midstates(&hk, &im, &om);
+    ls->h->first(&hk, job->salt, job->salt_len, (uint32_t)(b + 1), &u);
+    lane_put(ls, ls->im, l, &im);
+    lane_put(ls, ls->om, l, &om);
+    lane_put(ls, ls->wt, l, &u);
+    lane_put(ls, ls->t, l, &u);
+
+    ls->out[l]     = job->out + offset;
+    ls->out_len[l] = job->out_len - offset;
+    ls->left[l]    = job->iterations - 1;
+
+    if (offset + ls->h->hlen >= job->out_len) {
+        ls->next_job++;
+        ls->next_block = 0;
+    } else {
+        ls->next_block++;
+    }
+
+    memset(&hk, 0, sizeof(hk));
+    memset(&im, 0, sizeof(im));
+    memset(&om, 0, sizeof(om));
+    memset(&u, 0, sizeof(u));
+    return 1;
+}
+
+static void lane_finish(lane_set *ls, int l) {
+    hash_words t;
+    lane_get(ls, ls->t, l, &t);
+    store_digest(ls->h, &t, ls->out[l], ls->out_len[l]);
+    memset(&t, 0, sizeof(t));
+    ls->out[l] = NULL;
+}
+
+/* One iteration in every lane */
+static inline void lanes_step(lane_set *ls) {
+    size_t n = 8 * ls->row;
+
+    memcpy(ls->st, ls->im, n);
+    lanes_compress(ls);
+    memcpy(ls->wt, ls->st, n);
+    memcpy(ls->st, ls->om, n);
+    lanes_compress(ls);
+    for (size_t i = 0; i < n; i++) ls->t[i] ^= ls->st[i];
+    memcpy(ls->wt, ls->st, n);
+}
+
+static void lanes_run(lane_set *ls) {
+    const pbkdf2_hash *h = ls->h;
+    int lanes = ls->lanes, live = 0;
+
+    memset(ls->im, 0, sizeof(ls->im));
+    memset(ls->om, 0, sizeof(ls->om));
+    memset(ls->wt, 0, sizeof(ls->wt));
+    memset(ls->t, 0, sizeof(ls->t));
+
+    /* Message words 8..15: padding for a (block + hLen)-byte message */
+    hash_words pad;
+    memset(&pad, 0, sizeof(pad));
+    if (h->ws == 4) {
+        pad.w32[0] = 0x80000000u;
+        pad.w32[7] = (64 + 32) * 8;
+    } else {
+        pad.w64[0] = 0x8000000000000000ull;
+        pad.w64[7] = (128 + 64) * 8;
+    }
+    for (int l = 0; l < lanes; l++) {
+        lane_put(ls, ls->wt + 8 * ls->row, l, &pad);
+        ls->out[l] = NULL;
+        if (lane_start(ls, l)) live++;
+    }
+
+    while (live > 0 && (ls->next_job < ls->n_jobs || 2 * live >= lanes)) {
+        uint32_t steps = UINT32_MAX;
+        for (int l = 0; l < lanes; l++) {
+            if (ls->out[l] && ls->left[l] < steps) steps = ls->left[l];
+        }
+        for (uint32_t s = 0; s < steps; s++) lanes_step(ls);
+
+        for (int l = 0; l < lanes; l++) {
+            if (!ls->out[l]) continue;
+            ls->left[l] -= steps;
+            if (ls->left[l]) continue;
+            lane_finish(ls, l);
+            if (!lane_start(ls, l)) live--;
+        }
+    }
+
+    /* Too few chains left to fill a vector: finish them one at a time */
+    for (int l = 0; l < lanes; l++) {
+        if (!ls->out[l]) continue;
+        hash_words im, om, u, t;
+        lane_get(ls, ls->im, l, &im);
+        lane_get(ls, ls->om, l, &om);
+        lane_get(ls, ls->wt, l, &u);
+        lane_get(ls, ls->t, l, &t);
+        h->chain(&im, &om, &u, &t, ls->left[l]);
+        lane_put(ls, ls->t, l, &t);
+        lane_finish(ls, l);
+        memset(&im, 0, sizeof(im));
+        memset(&om, 0, sizeof(om));
+        memset(&u, 0, sizeof(u));
+        memset(&t, 0, sizeof(t));
+    }
+
+    memset(ls->im, 0, sizeof(ls->im));
+    memset(ls->om, 0, sizeof(ls->om));
+    memset(ls->st, 0, sizeof(ls->st));
+    memset(ls->wt, 0, sizeof(ls->wt));
+    memset(ls->t, 0, sizeof(ls->t));
+}
+
+typedef struct {
+    const pbkdf2_hash    *h;
+    const usr_pbkdf2_job *jobs;
+    size_t                n_jobs;
+    size_t                n_tasks;
+} pbkdf2_batch;
+
+/* Task `index` runs the index-th contiguous slice of the jobs */
+static void pbkdf2_batch_task(void *arg, size_t index) {
+    const pbkdf2_batch *batch = (const pbkdf2_batch *)arg;
+    size_t lo = batch->n_jobs * index / batch->n_tasks;
+    size_t hi = batch->n_jobs * (index + 1) / batch->n_tasks;
+    const pbkdf2_hash *h = batch->h;
+
+    lane_set ls;
+    ls.h     = h;
+    ls.lanes = h->lanes(&ls.k);
+
+    /* No lane kernel, or nothing to share it: one job at a time */
+    if (ls.lanes < 2 || hi - lo < 2) {
+        for (size_t j = lo; j < hi; j++) {
+            const usr_pbkdf2_job *job = &batch->jobs[j];
+            pbkdf2_key hk;
+            h->key_init(&hk, job->password, job->password_len);
+            for (size_t off = 0; off < job->out_len; off += h->hlen) {
+                pbkdf2_block(h, &hk, job->salt, job->salt_len,
+                             (uint32_t)(off / h->hlen + 1), job->iterations,
+                             job->out + off, job->out_len - off);
+            }
+            memset(&hk, 0, sizeof(hk));
+        }
+        return;
+    }
+
+    ls.row        = (size_t)ls.lanes * h->ws;
+    ls.jobs       = batch->jobs + lo;
+    ls.n_jobs     = hi - lo;
+    ls.next_job   = 0;
+    ls.next_block = 0;
+    lanes_run(&ls);
+}
+
+static int pbkdf2_many(const pbkdf2_hash *h, const usr_pbkdf2_job *jobs, size_t n_jobs) {
+    if (!jobs && n_jobs) return -1;
+
+    uint64_t work = 0;
+    for (size_t i = 0; i < n_jobs; i++) {
+        const usr_pbkdf2_job *job = &jobs[i];
+        if (!job->password || !job->salt || !job->out) return -1;
+        if (job->iterations == 0 || job->out_len == 0) return -1;
+        if ((uint64_t)(job->out_len - 1) / h->hlen >= 0xFFFFFFFFu) return -1;
+        work += (uint64_t)job->iterations * ((job->out_len + h->hlen - 1) / h->hlen);
+    }
+    if (n_jobs == 0) return 0;
+    if (n_jobs == 1) {
+        /* Nothing to batch; the single-job path threads over blocks */
+        return pbkdf2_run(h, jobs->password, jobs->password_len, jobs->salt,
+                          jobs->salt_len, jobs->iterations, jobs->out, jobs->out_len);
+    }
+
+    pbkdf2_batch batch;
+    batch.h       = h;
+    batch.jobs    = jobs;
+    batch.n_jobs  = n_jobs;
+    batch.n_tasks = 1;
+
+    /* Split across threads only while every slice can still fill its lanes */
+    if (work >= PBKDF2_PAR_MIN_WORK) {
+        lane_kernel k;
+        size_t lanes   = (size_t)h->lanes(&k);
+        size_t threads = (size_t)usr_parallel_threads();
+        size_t slices  = n_jobs / lanes;
+        if (slices < 1) slices = 1;
+        batch.n_tasks = slices < threads ? slices : threads;
+    }
+
+    if (batch.n_tasks > 1) usr_parallel_for(batch.n_tasks, pbkdf2_batch_task, &batch);
+    else                   pbkdf2_batch_task(&batch, 0);
+    return 0;
+}
+
+int usr_pbkdf2_sha256_many(const usr_pbkdf2_job *jobs, size_t n_jobs) {
+    return pbkdf2_many(&hash_sha256, jobs, n_jobs);
+}
+
+int usr_pbkdf2_sha512_many(const usr_pbkdf2_job *jobs, size_t n_jobs) {
+    return pbkdf2_many(&hash_sha512, jobs, n_jobs);
+}
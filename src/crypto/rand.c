@@ -1,4 +1,5 @@
 #include "usr/rand.h"
+#include "aes_impl.h"
 #include <stdint.h>
 #include <string.h>
 
@@ -7,6 +8,7 @@
 #  include <sys/stat.h>
 #  include <fcntl.h>
 #  include <unistd.h>
+#  include <pthread.h>
 #  ifdef __linux__
 #    include <sys/syscall.h>
 #    ifdef SYS_getrandom
@@ -15,26 +17,31 @@
 #    endif
 #  endif
 #  define USE_DEVURANDOM 1
+#  define USE_ATFORK 1
 #elif defined(_WIN32)
 #  include <windows.h>
 #  include <wincrypt.h>
 #  define USE_WINCRYPT 1
 #endif
 
+#if defined(_MSC_VER)
+#  define RAND_THREAD_LOCAL __declspec(thread)
+#else
+#  define RAND_THREAD_LOCAL _Thread_local
+#endif
+
 /* ============================================================
-   Fill `len` bytes with cryptographically random data.
+   Operating system entropy
    ============================================================ */
 
-int usr_rand_bytes(uint8_t *out, size_t len) {
-    if (!out || len == 0) return 0;
-
+static int os_random(uint8_t *out, size_t len) {
 #if defined(USE_GETRANDOM)
     /* getrandom() syscall (Linux 3.17+, Android 8+) */
-    ssize_t total = 0;
-    while ((size_t)total < len) {
-        long n = syscall(SYS_getrandom, out + total, len - total, 0);
+    size_t got = 0;
+    while (got < len) {
+        long n = syscall(SYS_getrandom, out + got, len - got, 0);
         if (n < 0) goto fallback_urandom;
-        total += n;
+        got += (size_t)n;
     }
     return 0;
 fallback_urandom:;
@@ -71,6 +78,141 @@ fallback_urandom:;
 #endif
 }
 
+/* ============================================================
+   Per-thread AES-256-CTR DRBG with fast key erasure
+
+   Each refill expands the current key, runs CTR from counter 0, and
+   replaces the key with the first 32 bytes of keystream before any
+   output is handed out, so a later state compromise reveals nothing
+   about earlier output. Served bytes are zeroed in the buffer.
+
+   The key is mixed with 32 fresh OS bytes on first use, every
+   RAND_RESEED_BYTES of output, and in a child after fork() (detected
+   through a generation counter bumped by a pthread_atfork handler).
+   ============================================================ */
+
+#define RAND_BATCH          32                  /* AES blocks per encrypt_blocks call */
+#define RAND_BUF            (RAND_BATCH * 16 - 32)
+#define RAND_BULK           RAND_BUF            /* requests this large bypass the buffer */
+#define RAND_RESEED_BYTES   (1u << 20)
+
+typedef struct {
+    uint8_t  key[32];
+    uint8_t  buf[RAND_BUF];
+    size_t   avail;                 /* unread bytes at the end of buf */
+    uint64_t since_reseed;
+    unsigned gen;
+    int      seeded;
+} rand_state;
+
+static RAND_THREAD_LOCAL rand_state _rng;
+
+static volatile unsigned _fork_gen = 0;
+
+#if defined(USE_ATFORK)
+static pthread_once_t _atfork_once = PTHREAD_ONCE_INIT;
+
+static void on_fork_child(void) { _fork_gen++; }
+
+static void register_atfork(void) {
+    pthread_atfork(NULL, NULL, on_fork_child);
+}
+#endif
+
+static int drbg_reseed(rand_state *st) {
+    uint8_t seed[32];
+#if defined(USE_ATFORK)
+    pthread_once(&_atfork_once, register_atfork);
+#endif
+    if (os_random(seed, sizeof(seed)) != 0) return -1;
+
+    for (int i = 0; i < 32; i++) st->key[i] ^= seed[i];
+    memset(seed, 0, sizeof(seed));
+
+    /* Anything buffered under the old key (or inherited over fork) goes */
+    memset(st->buf, 0, sizeof(st->buf));
+    st->avail        = 0;
+    st->since_reseed = 0;
+    st->gen          = _fork_gen;
+    st->seeded       = 1;
+    return 0;
+}
+
+/* Rekey and write `len` bytes of keystream to `out` */
+static void drbg_generate(rand_state *st, uint8_t *out, size_t len) {
+    const usr_aes_backend *be = usr_aes_backend_get();
+    uint8_t  rk[240], blocks[RAND_BATCH * 16];
+    uint64_t ctr = 0;
+    size_t   skip = 32;     /* first 32 bytes become the next key */
+
+    be->key_expand(st->key, rk);
+
+    while (len > 0) {
+        size_t want = skip + len;
+        size_t nblocks = (want + 15) / 16;
+        if (nblocks > RAND_BATCH) nblocks = RAND_BATCH;
+
+        memset(blocks, 0, nblocks * 16);
+        for (size_t b = 0; b < nblocks; b++, ctr++) {
+            memcpy(blocks + 16 * b, &ctr, sizeof(ctr));
+        }
+        be->encrypt_blocks(blocks, blocks, nblocks, rk);
+
+        size_t have = nblocks * 16;
+        if (skip) {
+            memcpy(st->key, blocks, 32);
+            have -= 32;
+        }
+        if (have > len) have = len;
+        memcpy(out, blocks + skip, have);
+        out += have;
+        len -= have;
+        skip = 0;
+    }
+
+    memset(rk, 0, sizeof(rk));
+    memset(blocks, 0, sizeof(blocks));
+}
+
+static inline int drbg_ready(rand_state *st, size_t len) {
+    if (!st->seeded || st->gen != _fork_gen ||
+        st->since_reseed >= RAND_RESEED_BYTES) {
+        if (drbg_reseed(st) != 0) return -1;
+    }
+    st->since_reseed += len;
+    return 0;
+}
+
+/* ============================================================
+   Fill `len` bytes with cryptographically random data.
+   ============================================================ */
+
+int usr_rand_bytes(uint8_t *out, size_t len) {
+    if (!out || len == 0) return 0;
+
+    rand_state *st = &_rng;
+    if (drbg_ready(st, len) != 0) return -1;
+
+    for (;;) {
+        size_t take = st->avail < len ? st->avail : len;
+        uint8_t *src = st->buf + RAND_BUF - st->avail;
+        memcpy(out, src, take);
+        memset(src, 0, take);
+        st->avail -= take;
+        out += take;
+        len -= take;
+        if (len == 0) return 0;
+
+        if (len >= RAND_BULK) {
+            /* Straight into the caller's buffer */
+            drbg_generate(st, out, len);
+            return 0;
+        }
+        drbg_generate(st, st->buf, RAND_BUF);
+        st->avail = RAND_BUF;
+    }
+}
+
 uint64_t usr_rand_u64(void) {
     uint64_t v = 0;
     usr_rand_bytes((uint8_t *)&v, sizeof(v));
@@ -83,13 +225,59 @@ uint32_t usr_rand_u32(void) {
     return v;
 }
 
+/* Rejection threshold: values below it would bias v % max */
+static inline uint64_t range_threshold(uint64_t max) {
+    return (uint64_t)(-(int64_t)max) % max;
+}
+
 uint64_t usr_rand_range(uint64_t max) {
     if (max == 0) return 0;
     /* Rejection sampling to avoid modulo bias */
-    uint64_t threshold = (uint64_t)(-(int64_t)max) % max;
+    uint64_t threshold = range_threshold(max);
     uint64_t v;
     do {
         v = usr_rand_u64();
     } while (v < threshold);
     return v % max;
 }
+
+int usr_rand_fill_range(uint64_t *out, size_t n, uint64_t max) {
+    if (n == 0) return 0;
+    if (!out) return -1;
+    if (max == 0) {
+        memset(out, 0, n * sizeof(*out));
+        return 0;
+    }
+    if (usr_rand_bytes((uint8_t *)out, n * sizeof(*out)) != 0) return -1;
+
+    uint64_t threshold = range_threshold(max);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v = out[i];
+        while (v < threshold) v = usr_rand_u64();
+        out[i] = v % max;
+    }
+    return 0;
+}
+
+int usr_rand_fill_range_u32(uint32_t *out, size_t n, uint32_t max) {
+    if (n == 0) return 0;
+    if (!out) return -1;
+    if (max == 0) {
+        memset(out, 0, n * sizeof(*out));
+        return 0;
+    }
+    if (usr_rand_bytes((uint8_t *)out, n * sizeof(*out)) != 0) return -1;
+
+    /* Multiply-shift (Lemire): the high word of v * max is uniform in
+       [0, max) once the low word clears the threshold, which is only
+       computed in the rare case it could matter. */
+    for (size_t i = 0; i < n; i++) {
+        uint64_t m = (uint64_t)out[i] * max;
+        if ((uint32_t)m < max) {
+            uint32_t threshold = (uint32_t)(-max) % max;
+            while ((uint32_t)m < threshold) m = (uint64_t)usr_rand_u32() * max;
+        }
+        out[i] = (uint32_t)(m >> 32);
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "usr/crypto.h"
+#include "sha_impl.h"
+#include "cpu_features.h"
+#include <string.h>
+#include <stdint.h>
+
+/* ============================================================
+   SHA-1 Implementation (FIPS 180-4)
+   Same streaming shape as SHA-256. Only for protocols that still
+   require it (MTProto auth_key_id, key fingerprints); not for new
+   designs. Blocks go through the SHA-NI kernel when available.
+   ============================================================ */
+
+static const uint32_t H0[5] = {
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+};
+
+#define ROTL32(x, n)  (((x) << (n)) | ((x) >> (32 - (n))))
+
+/* Process one 64-byte block */
+static void sha1_compress_block(uint32_t state[5], const uint8_t block[64]) {
+    uint32_t w[80];
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[i*4  ] << 24)
+             | ((uint32_t)block[i*4+1] << 16)
+             | ((uint32_t)block[i*4+2] <<  8)
+             | ((uint32_t)block[i*4+3]);
+    }
+    for (i = 16; i < 80; i++) {
+        w[i] = ROTL32(w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16], 1);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    for (i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5a827999; }
+        else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ed9eba1; }
+        else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8f1bbcdc; }
+        else             { f = b ^ c ^ d;                   k = 0xca62c1d6; }
+        uint32_t t = ROTL32(a, 5) + f + e + k + w[i];
+        e = d; d = c; c = ROTL32(b, 30); b = a; a = t;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e;
+}
+
+/* Process `nblocks` consecutive 64-byte blocks */
+void usr_sha1_compress(uint32_t state[5], const uint8_t *data, size_t nblocks) {
+    if (usr_sha1_shani_compiled() && usr_cpu_has(USR_CPU_SHA | USR_CPU_SSE41)) {
+        usr_sha1_shani_compress(state, data, nblocks);
+        return;
+    }
+    for (size_t i = 0; i < nblocks; i++) {
+        sha1_compress_block(state, data + 64 * i);
+    }
+}
+
+/* ============================================================
+   Streaming API
+   ============================================================ */
+
+void usr_sha1_init(usr_sha1_ctx *ctx) {
+    for (int i = 0; i < 5; i++) ctx->state[i] = H0[i];
+    ctx->bitcount = 0;
+    ctx->buflen   = 0;
+}
+
+void usr_sha1_update(usr_sha1_ctx *ctx, const uint8_t *data, size_t len) {
+    if (!ctx || !data || len == 0) return;
+
+    ctx->bitcount += (uint64_t)len << 3;
+
+    size_t i = 0;
+    if (ctx->buflen > 0) {
+        size_t need = 64 - ctx->buflen;
+        size_t fill = (len < need) ? len : need;
+        memcpy(ctx->buf + ctx->buflen, data, fill);
+        ctx->buflen += (uint32_t)fill;
+        i += fill;
+        if (ctx->buflen == 64) {
+            usr_sha1_compress(ctx->state, ctx->buf, 1);
+            ctx->buflen = 0;
+        }
+    }
+
+    if (len - i >= 64) {
+        size_t nblocks = (len - i) / 64;
+        usr_sha1_compress(ctx->state, data + i, nblocks);
+        i += nblocks * 64;
+    }
+
+    if (i < len) {
+        size_t rem = len - i;
+        memcpy(ctx->buf, data + i, rem);
+        ctx->buflen = (uint32_t)rem;
+    }
+}
+
+void usr_sha1_final(usr_sha1_ctx *ctx, uint8_t out[20]) {
+    if (!ctx || !out) return;
+
+    uint64_t bitcount = ctx->bitcount;
+    uint32_t buflen   = ctx->buflen;
+
+    ctx->buf[buflen++] = 0x80;
+
+    if (buflen > 56) {
+        memset(ctx->buf + buflen, 0, 64 - buflen);
+        usr_sha1_compress(ctx->state, ctx->buf, 1);
+        buflen = 0;
+    }
+
+    memset(ctx->buf + buflen, 0, 56 - buflen);
+    for (int i = 0; i < 8; i++) {
+        ctx->buf[56 + i] = (uint8_t)(bitcount >> (56 - 8 * i));
+    }
+    usr_sha1_compress(ctx->state, ctx->buf, 1);
+
+    for (int i = 0; i < 5; i++) {
+        out[i*4  ] = (uint8_t)(ctx->state[i] >> 24);
+        out[i*4+1] = (uint8_t)(ctx->state[i] >> 16);
+        out[i*4+2] = (uint8_t)(ctx->state[i] >>  8);
+        out[i*4+3] = (uint8_t)(ctx->state[i]      );
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void usr_sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+    usr_sha1_ctx ctx;
+    usr_sha1_init(&ctx);
+    usr_sha1_update(&ctx, data, len);
+    usr_sha1_final(&ctx, out);
+}
@@ -0,0 +1,78 @@
+#include "sha_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+
+/* ============================================================
+   SHA-1 using the x86 SHA extensions
+   (SHA1RNDS4 / SHA1NEXTE / SHA1MSG1 / SHA1MSG2).
+
+   ABCD lives in one register (A in the top lane) and E in the top
+   lane of another. Each group of four rounds derives the next E
+   from the previous ABCD, and advances the message schedule for
+   the group three ahead: MSG1, then XOR, then MSG2.
+   ============================================================ */
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define SHANI_TARGET USR_TARGET("sha,sse4.1,ssse3,sse2")
+
+/* Rounds 4g .. 4g+3. E alternates between e0 (even g) and e1 (odd g);
+   the other one receives ABCD for the next group. */
+#define ROUNDS4(g) do {                                                         \
+        if ((g) == 0)     e0 = _mm_add_epi32(e0, m[0]);                         \
+        else if ((g) & 1) e1 = _mm_sha1nexte_epu32(e1, m[(g) & 3]);             \
+        else              e0 = _mm_sha1nexte_epu32(e0, m[(g) & 3]);             \
+        if ((g) & 1) e0 = abcd; else e1 = abcd;                                 \
+        if ((g) >= 3 && (g) <= 18)                                              \
+            m[((g) + 1) & 3] = _mm_sha1msg2_epu32(m[((g) + 1) & 3], m[(g) & 3]); \
+        abcd = _mm_sha1rnds4_epu32(abcd, ((g) & 1) ? e1 : e0, (g) / 5);         \
+        if ((g) >= 1 && (g) <= 16)                                              \
+            m[((g) + 3) & 3] = _mm_sha1msg1_epu32(m[((g) + 3) & 3], m[(g) & 3]); \
+        if ((g) >= 2 && (g) <= 17)                                              \
+            m[((g) + 2) & 3] = _mm_xor_si128(m[((g) + 2) & 3], m[(g) & 3]);     \
+    } while (0)
+
+SHANI_TARGET
+void usr_sha1_shani_compress(uint32_t state[5], const uint8_t *data, size_t nblocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0x1B);
+    __m128i e0   = _mm_set_epi32((int)state[4], 0, 0, 0);
+    __m128i e1;
+
+    for (; nblocks > 0; nblocks--, data += 64) {
+        __m128i abcd_in = abcd, e_in = e0;
+        __m128i m[4];
+        m[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap);
+        m[1] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), bswap);
+        m[2] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), bswap);
+        m[3] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), bswap);
+
+        ROUNDS4(0);  ROUNDS4(1);  ROUNDS4(2);  ROUNDS4(3);
+        ROUNDS4(4);  ROUNDS4(5);  ROUNDS4(6);  ROUNDS4(7);
+        ROUNDS4(8);  ROUNDS4(9);  ROUNDS4(10); ROUNDS4(11);
+        ROUNDS4(12); ROUNDS4(13); ROUNDS4(14); ROUNDS4(15);
+        ROUNDS4(16); ROUNDS4(17); ROUNDS4(18); ROUNDS4(19);
+
+        e0   = _mm_sha1nexte_epu32(e0, e_in);
+        abcd = _mm_add_epi32(abcd, abcd_in);
+    }
+
+    _mm_storeu_si128((__m128i *)state, _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+int usr_sha1_shani_compiled(void) { return 1; }
+
+#else /* !USR_X86 */
+
+/* Never selected: usr_sha1_shani_compiled() reports it as unavailable. */
+void usr_sha1_shani_compress(uint32_t state[5], const uint8_t *data, size_t nblocks) {
+    (void)state; (void)data; (void)nblocks;
+}
+
+int usr_sha1_shani_compiled(void) { return 0; }
+
+#endif
@@ -1,4 +1,6 @@
 #include "usr/crypto.h"
+#include "sha_impl.h"
+#include "cpu_features.h"
 #include <string.h>
 #include <stdint.h>
 
@@ -6,10 +8,12 @@
    SHA-256 Implementation (FIPS 180-4 compliant)
    Supports streaming via init/update/final API.
    One-shot convenience wrapper: usr_sha256().
+   Blocks go through the SHA-NI kernel when the CPU has it, else
+   through a vectorised-schedule kernel (AVX2 / SSSE3).
    ============================================================ */
 
 /* SHA-256 round constants */
-static const uint32_t K[64] = {
+const uint32_t usr_sha256_k[64] = {
     0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
     0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
     0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
@@ -43,7 +47,7 @@ static const uint32_t H0[8] = {
 #define SIG1(x)       (ROTR32(x, 17) ^ ROTR32(x, 19) ^ ((x) >> 10))
 
 /* Process one 64-byte block */
-static void sha256_compress(uint32_t state[8], const uint8_t block[64]) {
+static void sha256_compress_block(uint32_t state[8], const uint8_t block[64]) {
     uint32_t w[64];
     int i;
 
@@ -64,7 +68,7 @@ static void sha256_compress(uint32_t state[8], const uint8_t block[64]) {
 
     /* 64 rounds */
     for (i = 0; i < 64; i++) {
-        uint32_t t1 = h + EP1(e) + CH(e, f, g) + K[i] + w[i];
+        uint32_t t1 = h + EP1(e) + CH(e, f, g) + usr_sha256_k[i] + w[i];
         uint32_t t2 = EP0(a) + MAJ(a, b, c);
         h = g; g = f; f = e; e = d + t1;
         d = c; c = b; b = a; a = t1 + t2;
@@ -75,6 +79,27 @@ static void sha256_compress(uint32_t state[8], const uint8_t block[64]) {
     state[4] += e; state[5] += f; state[6] += g; state[7] += h;
 }
 
+/* Process `nblocks` consecutive 64-byte blocks */
+void usr_sha256_compress(uint32_t state[8], const uint8_t *data, size_t nblocks) {
+    if (usr_sha256_shani_compiled() && usr_cpu_has(USR_CPU_SHA | USR_CPU_SSE41)) {
+        usr_sha256_shani_compress(state, data, nblocks);
+        return;
+    }
+    if (usr_sha256_simd_compiled()) {
+        if (usr_cpu_has(USR_CPU_AVX2 | USR_CPU_BMI2)) {
+            usr_sha256_avx2_compress(state, data, nblocks);
+            return;
+        }
+        if (usr_cpu_has(USR_CPU_SSSE3)) {
+            usr_sha256_ssse3_compress(state, data, nblocks);
+            return;
+        }
+    }
+    for (size_t i = 0; i < nblocks; i++) {
+        sha256_compress_block(state, data + 64 * i);
+    }
+}
+
 /* ============================================================
    Streaming API
    ============================================================ */
@@ -99,15 +124,16 @@ void usr_sha256_update(usr_sha256_ctx *ctx, const uint8_t *data, size_t len) {
         ctx->buflen += (uint32_t)fill;
         i += fill;
         if (ctx->buflen == 64) {
-            sha256_compress(ctx->state, ctx->buf);
+            usr_sha256_compress(ctx->state, ctx->buf, 1);
             ctx->buflen = 0;
         }
     }
 
     /* Process full blocks directly from input */
-    while (i + 64 <= len) {
-        sha256_compress(ctx->state, data + i);
-        i += 64;
+    if (len - i >= 64) {
+        size_t nblocks = (len - i) / 64;
+        usr_sha256_compress(ctx->state, data + i, nblocks);
+        i += nblocks * 64;
     }
 
     /* Buffer remaining bytes */
@@ -130,7 +156,7 @@ void usr_sha256_final(usr_sha256_ctx *ctx, uint8_t out[32]) {
     /* If not enough room for length (8 bytes), flush and start new block */
     if (buflen > 56) {
         memset(ctx->buf + buflen, 0, 64 - buflen);
-        sha256_compress(ctx->state, ctx->buf);
+        usr_sha256_compress(ctx->state, ctx->buf, 1);
         buflen = 0;
     }
 
@@ -144,7 +170,7 @@ void usr_sha256_final(usr_sha256_ctx *ctx, uint8_t out[32]) {
     ctx->buf[61] = (uint8_t)(bitcount >> 16);
     ctx->buf[62] = (uint8_t)(bitcount >>  8);
     ctx->buf[63] = (uint8_t)(bitcount      );
-    sha256_compress(ctx->state, ctx->buf);
+    usr_sha256_compress(ctx->state, ctx->buf, 1);
 
     /* Write digest big-endian */
     for (int i = 0; i < 8; i++) {
@@ -158,6 +184,59 @@ void usr_sha256_final(usr_sha256_ctx *ctx, uint8_t out[32]) {
     memset(ctx, 0, sizeof(*ctx));
 }
 
+/* ============================================================
+   Midstate export / import / clone
+   Layout (USR_SHA256_EXPORT_SIZE bytes, all integers big-endian):
+     [0..3]    'u' 's' 0x20 version
+     [4..35]   state words
+     [36..43]  message length in bits
+     [44]      buffered bytes (< 64)
+     [45..108] buffer, zero past the buffered bytes
+   ============================================================ */
+
+#define SHA256_EXPORT_VERSION 1
+
+int usr_sha256_export(const usr_sha256_ctx *ctx, uint8_t out[USR_SHA256_EXPORT_SIZE]) {
+    if (!ctx || !out || ctx->buflen >= 64) return -1;
+
+    uint8_t *p = out;
+    *p++ = 'u'; *p++ = 's'; *p++ = 0x20; *p++ = SHA256_EXPORT_VERSION;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 4; j++) *p++ = (uint8_t)(ctx->state[i] >> (24 - 8 * j));
+    }
+    for (int j = 0; j < 8; j++) *p++ = (uint8_t)(ctx->bitcount >> (56 - 8 * j));
+    *p++ = (uint8_t)ctx->buflen;
+    memcpy(p, ctx->buf, ctx->buflen);
+    memset(p + ctx->buflen, 0, 64 - ctx->buflen);
+    return 0;
+}
+
+int usr_sha256_import(usr_sha256_ctx *ctx, const uint8_t in[USR_SHA256_EXPORT_SIZE]) {
+    if (!ctx || !in) return -1;
+    if (in[0] != 'u' || in[1] != 's' || in[2] != 0x20 || in[3] != SHA256_EXPORT_VERSION) return -1;
+
+    const uint8_t *p = in + 4;
+    uint64_t bitcount = 0;
+    for (int j = 0; j < 8; j++) bitcount = (bitcount << 8) | p[32 + j];
+    uint32_t buflen = p[40];
+    /* The buffer holds exactly the bytes past the last whole block */
+    if (buflen >= 64 || (bitcount & 7) || (bitcount >> 3) % 64 != buflen) return -1;
+
+    for (int i = 0; i < 8; i++) {
+        ctx->state[i] = ((uint32_t)p[i*4] << 24) | ((uint32_t)p[i*4+1] << 16) |
+                        ((uint32_t)p[i*4+2] << 8) | (uint32_t)p[i*4+3];
+    }
+    ctx->bitcount = bitcount;
+    ctx->buflen   = buflen;
+    memcpy(ctx->buf, p + 41, buflen);
+    memset(ctx->buf + buflen, 0, 64 - buflen);
+    return 0;
+}
+
+void usr_sha256_clone(usr_sha256_ctx *dst, const usr_sha256_ctx *src) {
+    if (dst && src) *dst = *src;
+}
+
 /* ============================================================
    One-shot convenience wrapper
    ============================================================ */
@@ -0,0 +1,275 @@
+#include "usr/crypto.h"
+#include "sha_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+#include <string.h>
+
+/* ============================================================
+   Multi-buffer SHA-256
+
+   Independent messages run in SIMD lanes, one 32-bit word of each
+   message per lane: 8 lanes with AVX2, 16 with AVX-512. Every step
+   compresses one block in every lane. A lane that finishes its
+   message is refilled from the job list straight away, so messages
+   of mixed lengths keep the lanes busy. Once no jobs are left and
+   fewer than half the lanes are live, the stragglers finish on the
+   single-stream path (SHA-NI / AVX2 / scalar).
+   Roughly 4x over scalar for one- and two-block messages with AVX2;
+   AVX-512 is ~1.4x over SHA-NI.
+   ============================================================ */
+
+#define MB_MAX_LANES 16
+
+static const uint32_t H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static inline uint32_t load32_be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8)  |  (uint32_t)p[3];
+}
+
+static inline void store32_be(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);  p[3] = (uint8_t)v;
+}
+
+/* Gather word j of every lane's block into wt[j * lanes + lane] */
+static inline void transpose_block(uint32_t *wt, const uint8_t *const *blocks, int lanes) {
+    for (int l = 0; l < lanes; l++) {
+        for (int j = 0; j < 16; j++) wt[j * lanes + l] = load32_be(blocks[l] + 4 * j);
+    }
+}
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define AVX2_TARGET   USR_TARGET("avx2")
+#define AVX512_TARGET USR_TARGET("avx512f")
+
+/* 64 rounds shared by both kernels; needs V, ADD, ROTR, XOR3, CH,
+   MAJ, SHR, SET1, LOAD and STORE for the vector type */
+#define MB_COMPRESS(LANES)                                                      \
+    V w[16];                                                                    \
+    for (int j = 0; j < 16; j++) w[j] = LOAD(wt + j * LANES);                   \
+                                                                                \
+    V a = LOAD(st),             b = LOAD(st + LANES);                           \
+    V c = LOAD(st + 2 * LANES), d = LOAD(st + 3 * LANES);                       \
+    V e = LOAD(st + 4 * LANES), f = LOAD(st + 5 * LANES);                       \
+    V g = LOAD(st + 6 * LANES), h = LOAD(st + 7 * LANES);                       \
+                                                                                \
+    for (int i = 0; i < 64; i++) {                                              \
+        if (i >= 16) {                                                          \
+            V w2 = w[(i - 2) & 15], w15 = w[(i - 15) & 15];                     \
+            V s0 = XOR3(ROTR(w15, 7), ROTR(w15, 18), SHR(w15, 3));              \
+            V s1 = XOR3(ROTR(w2, 17), ROTR(w2, 19), SHR(w2, 10));               \
+            w[i & 15] = ADD(ADD(w[i & 15], s0), ADD(w[(i - 7) & 15], s1));      \
+        }                                                                       \
+        V t1 = ADD(ADD(h, XOR3(ROTR(e, 6), ROTR(e, 11), ROTR(e, 25))),          \
+                   ADD(CH(e, f, g), ADD(SET1(usr_sha256_k[i]), w[i & 15])));    \
+        V t2 = ADD(XOR3(ROTR(a, 2), ROTR(a, 13), ROTR(a, 22)), MAJ(a, b, c));   \
+        h = g; g = f; f = e; e = ADD(d, t1);                                    \
+        d = c; c = b; b = a; a = ADD(t1, t2);                                   \
+    }                                                                           \
+                                                                                \
+    STORE(st,             ADD(a, LOAD(st)));                                    \
+    STORE(st + LANES,     ADD(b, LOAD(st + LANES)));                            \
+    STORE(st + 2 * LANES, ADD(c, LOAD(st + 2 * LANES)));                        \
+    STORE(st + 3 * LANES, ADD(d, LOAD(st + 3 * LANES)));                        \
+    STORE(st + 4 * LANES, ADD(e, LOAD(st + 4 * LANES)));                        \
+    STORE(st + 5 * LANES, ADD(f, LOAD(st + 5 * LANES)));                        \
+    STORE(st + 6 * LANES, ADD(g, LOAD(st + 6 * LANES)));                        \
+    STORE(st + 7 * LANES, ADD(h, LOAD(st + 7 * LANES)))
+
+/* ---- AVX2: 8 lanes ---- */
+
+#define V          __m256i
+#define ADD        _mm256_add_epi32
+#define SHR        _mm256_srli_epi32
+#define SET1(k)    _mm256_set1_epi32((int)(k))
+#define LOAD(p)    _mm256_load_si256((const __m256i *)(p))
+#define STORE(p,v) _mm256_store_si256((__m256i *)(p), (v))
+#define ROTR(x,n)  _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define XOR3(x,y,z) _mm256_xor_si256(_mm256_xor_si256((x), (y)), (z))
+#define CH(x,y,z)  _mm256_xor_si256(_mm256_and_si256((x), (y)), _mm256_andnot_si256((x), (z)))
+#define MAJ(x,y,z) _mm256_or_si256(_mm256_and_si256((x), (y)), \
+                                   _mm256_and_si256((z), _mm256_or_si256((x), (y))))
+
+AVX2_TARGET
+static void sha256_x8_avx2(uint32_t *st, const uint32_t *wt) {
+    MB_COMPRESS(8);
+}
+
+#undef V
+#undef ADD
+#undef SHR
+#undef SET1
+#undef LOAD
+#undef STORE
+#undef ROTR
+#undef XOR3
+#undef CH
+#undef MAJ
+
+/* ---- AVX-512: 16 lanes, native rotates and ternary logic ---- */
+
+#define V          __m512i
+#define ADD        _mm512_add_epi32
+#define SHR        _mm512_srli_epi32
+#define SET1(k)    _mm512_set1_epi32((int)(k))
+#define LOAD(p)    _mm512_load_si512((const void *)(p))
+#define STORE(p,v) _mm512_store_si512((void *)(p), (v))
+#define ROTR(x,n)  _mm512_ror_epi32((x), (n))
+#define XOR3(x,y,z) _mm512_ternarylogic_epi32((x), (y), (z), 0x96)
+#define CH(x,y,z)  _mm512_ternarylogic_epi32((x), (y), (z), 0xCA)
+#define MAJ(x,y,z) _mm512_ternarylogic_epi32((x), (y), (z), 0xE8)
+
+AVX512_TARGET
+static void sha256_x16_avx512(uint32_t *st, const uint32_t *wt) {
+    MB_COMPRESS(16);
+}
+
+#undef V
+#undef ADD
+#undef SHR
+#undef SET1
+#undef LOAD
+#undef STORE
+#undef ROTR
+#undef XOR3
+#undef CH
+#undef MAJ
+
+#endif /* USR_X86 */
+
+usr_sha256_lanes_fn usr_sha256_lanes_select(int *lanes) {
+#if USR_X86
+    if (usr_cpu_has(USR_CPU_AVX512F)) { *lanes = 16; return sha256_x16_avx512; }
+    if (usr_cpu_has(USR_CPU_AVX2))    { *lanes = 8;  return sha256_x8_avx2; }
+#endif
+    *lanes = 1;
+    return NULL;
+}
+
+/* ============================================================
+   Lane scheduler
+   ============================================================ */
+
+typedef struct {
+    const usr_sha256_job *job;      /* NULL when idle */
+    const uint8_t        *data;     /* next full block of the message */
+    size_t                full;     /* full message blocks left */
+    int                   npad;     /* padding blocks (1 or 2) */
+    int                   pad_used;
+    uint8_t               pad[128];
+} mb_lane;
+
+static void lane_start(mb_lane *ln, const usr_sha256_job *job) {
+    size_t   rem  = job->len % 64;
+    uint64_t bits = (uint64_t)job->len << 3;
+
+    ln->job      = job;
+    ln->data     = job->data;
+    ln->full     = job->len / 64;
+    ln->npad     = rem + 9 > 64 ? 2 : 1;
+    ln->pad_used = 0;
+
+    memset(ln->pad, 0, sizeof(ln->pad));
+    if (rem) memcpy(ln->pad, job->data + 64 * ln->full, rem);
+    ln->pad[rem] = 0x80;
+    uint8_t *end = ln->pad + 64 * ln->npad;
+    store32_be(end - 8, (uint32_t)(bits >> 32));
+    store32_be(end - 4, (uint32_t)bits);
+}
+
+static inline const uint8_t *lane_block(const mb_lane *ln) {
+    return ln->full ? ln->data : ln->pad + 64 * ln->pad_used;
+}
+
+/* Step past the block just compressed; returns 1 when the message is done */
+static inline int lane_advance(mb_lane *ln) {
+    if (ln->full) {
+        ln->data += 64;
+        ln->full--;
+        return 0;
+    }
+    return ++ln->pad_used == ln->npad;
+}
+
+static void lane_digest(const uint32_t state[8], uint8_t out[32]) {
+    for (int i = 0; i < 8; i++) store32_be(out + 4 * i, state[i]);
+}
+
+int usr_sha256_many(const usr_sha256_job *jobs, size_t n_jobs) {
+    if (!jobs && n_jobs) return -1;
+    for (size_t i = 0; i < n_jobs; i++) {
+        if (!jobs[i].out || (!jobs[i].data && jobs[i].len)) return -1;
+    }
+
+    /* With the per-block transpose, SHA-NI outruns 8 AVX2 lanes,
+       but not 16 AVX-512 ones */
+    int lanes;
+    usr_sha256_lanes_fn kernel = usr_sha256_lanes_select(&lanes);
+    if (lanes == 8 && usr_cpu_has(USR_CPU_SHA)) kernel = NULL;
+    if (!kernel || n_jobs < 2) {
+        for (size_t i = 0; i < n_jobs; i++) usr_sha256(jobs[i].data, jobs[i].len, jobs[i].out);
+        return 0;
+    }
+
+    static const uint8_t idle_block[64] = {0};
+    _Alignas(64) uint32_t st[8 * MB_MAX_LANES];
+    _Alignas(64) uint32_t wt[16 * MB_MAX_LANES];
+    const uint8_t *blocks[MB_MAX_LANES];
+    mb_lane        ln[MB_MAX_LANES];
+    size_t         next = 0;
+    int            live = 0;
+
+    for (int l = 0; l < lanes; l++) {
+        ln[l].job = NULL;
+        if (next < n_jobs) {
+            lane_start(&ln[l], &jobs[next++]);
+            for (int i = 0; i < 8; i++) st[i * lanes + l] = H0[i];
+            live++;
+        }
+    }
+
+    while (live > 0 && (next < n_jobs || 2 * live >= lanes)) {
+        for (int l = 0; l < lanes; l++) {
+            blocks[l] = ln[l].job ? lane_block(&ln[l]) : idle_block;
+        }
+        transpose_block(wt, blocks, lanes);
+        kernel(st, wt);
+
+        for (int l = 0; l < lanes; l++) {
+            if (!ln[l].job || !lane_advance(&ln[l])) continue;
+
+            uint32_t state[8];
+            for (int i = 0; i < 8; i++) state[i] = st[i * lanes + l];
+            lane_digest(state, ln[l].job->out);
+
+            if (next < n_jobs) {
+                lane_start(&ln[l], &jobs[next++]);
+                for (int i = 0; i < 8; i++) st[i * lanes + l] = H0[i];
+            } else {
+                ln[l].job = NULL;
+                live--;
+            }
+        }
+    }
+
+    /* Too few lanes left to fill a vector: finish them one at a time */
+    for (int l = 0; l < lanes; l++) {
+        if (!ln[l].job) continue;
+        uint32_t state[8];
+        for (int i = 0; i < 8; i++) state[i] = st[i * lanes + l];
+        usr_sha256_compress(state, ln[l].data, ln[l].full);
+        usr_sha256_compress(state, ln[l].pad + 64 * ln[l].pad_used,
+                            (size_t)(ln[l].npad - ln[l].pad_used));
+        lane_digest(state, ln[l].job->out);
+    }
+
+    memset(ln, 0, sizeof(ln));
+    return 0;
+}
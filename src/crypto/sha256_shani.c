@@ -0,0 +1,94 @@
+#include "sha_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+
+/* ============================================================
+   SHA-256 using the x86 SHA extensions
+   (SHA256RNDS2 / SHA256MSG1 / SHA256MSG2).
+
+   The state lives in two registers as ABEF / CDGH, the layout
+   SHA256RNDS2 expects, for the whole run of blocks. Each group of
+   four rounds also advances the message schedule by four words.
+   ============================================================ */
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define SHANI_TARGET USR_TARGET("sha,sse4.1,ssse3,sse2")
+
+/* Four rounds with schedule words `w` */
+#define ROUNDS4(i, w) do {                                                      \
+        __m128i t_ = _mm_add_epi32((w),                                         \
+            _mm_loadu_si128((const __m128i *)(usr_sha256_k + 4 * (i))));        \
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t_);                           \
+        t_   = _mm_shuffle_epi32(t_, 0x0E);                                     \
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, t_);                           \
+    } while (0)
+
+/* Finish the next four schedule words: next holds MSG1 output */
+#define SCHED(cur, prev, next) \
+    (next) = _mm_sha256msg2_epu32(_mm_add_epi32((next), _mm_alignr_epi8((cur), (prev), 4)), (cur))
+
+#define MSG1(prev, cur) (prev) = _mm_sha256msg1_epu32((prev), (cur))
+
+SHANI_TARGET
+void usr_sha256_shani_compress(uint32_t state[8], const uint8_t *data, size_t nblocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    /* ABCD / EFGH -> ABEF / CDGH */
+    __m128i t    = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0xB1);
+    __m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(state + 4)), 0x1B);
+    __m128i abef = _mm_alignr_epi8(t, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, t, 0xF0);
+
+    for (; nblocks > 0; nblocks--, data += 64) {
+        __m128i abef_in = abef, cdgh_in = cdgh;
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), bswap);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), bswap);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), bswap);
+
+        ROUNDS4(0, m0);
+        ROUNDS4(1, m1);  MSG1(m0, m1);
+        ROUNDS4(2, m2);  MSG1(m1, m2);
+        ROUNDS4(3, m3);  SCHED(m3, m2, m0); MSG1(m2, m3);
+
+        ROUNDS4(4, m0);  SCHED(m0, m3, m1); MSG1(m3, m0);
+        ROUNDS4(5, m1);  SCHED(m1, m0, m2); MSG1(m0, m1);
+        ROUNDS4(6, m2);  SCHED(m2, m1, m3); MSG1(m1, m2);
+        ROUNDS4(7, m3);  SCHED(m3, m2, m0); MSG1(m2, m3);
+
+        ROUNDS4(8, m0);  SCHED(m0, m3, m1); MSG1(m3, m0);
+        ROUNDS4(9, m1);  SCHED(m1, m0, m2); MSG1(m0, m1);
+        ROUNDS4(10, m2); SCHED(m2, m1, m3); MSG1(m1, m2);
+        ROUNDS4(11, m3); SCHED(m3, m2, m0); MSG1(m2, m3);
+
+        ROUNDS4(12, m0); SCHED(m0, m3, m1); MSG1(m3, m0);
+        ROUNDS4(13, m1); SCHED(m1, m0, m2);
+        ROUNDS4(14, m2); SCHED(m2, m1, m3);
+        ROUNDS4(15, m3);
+
+        abef = _mm_add_epi32(abef, abef_in);
+        cdgh = _mm_add_epi32(cdgh, cdgh_in);
+    }
+
+    /* ABEF / CDGH -> ABCD / EFGH */
+    t    = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128((__m128i *)state, _mm_blend_epi16(t, cdgh, 0xF0));
+    _mm_storeu_si128((__m128i *)(state + 4), _mm_alignr_epi8(cdgh, t, 8));
+}
+
+int usr_sha256_shani_compiled(void) { return 1; }
+
+#else /* !USR_X86 */
+
+/* Never selected: usr_sha256_shani_compiled() reports it as unavailable. */
+void usr_sha256_shani_compress(uint32_t state[8], const uint8_t *data, size_t nblocks) {
+    (void)state; (void)data; (void)nblocks;
+}
+
+int usr_sha256_shani_compiled(void) { return 0; }
+
+#endif
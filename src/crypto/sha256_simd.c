@@ -0,0 +1,225 @@
+#include "sha_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+
+/* ============================================================
+   SHA-256 with a vectorised message schedule (SSSE3 / AVX2)
+
+   For CPUs without the SHA extensions. The schedule is expanded
+   four words per vector op and stored as W + K, so the scalar
+   rounds only do one load and one add per round. The AVX2 kernel
+   expands two blocks at once, one per 128-bit lane, and its rounds
+   are compiled for BMI2 so rotations become RORX.
+   ============================================================ */
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define SSSE3_TARGET USR_TARGET("ssse3,sse2")
+#define AVX2_TARGET  USR_TARGET("avx2,bmi2")
+
+#define ROTR32(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+#define EP0(x)        (ROTR32(x, 2)  ^ ROTR32(x, 13) ^ ROTR32(x, 22))
+#define EP1(x)        (ROTR32(x, 6)  ^ ROTR32(x, 11) ^ ROTR32(x, 25))
+#define CH(x, y, z)   (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)  (((x) & (y)) | ((z) & ((x) | (y))))
+
+#define RND(a, b, c, d, e, f, g, h, wk) do {                  \
+        uint32_t t1_ = (h) + EP1(e) + CH(e, f, g) + (wk);     \
+        uint32_t t2_ = EP0(a) + MAJ(a, b, c);                 \
+        (d) += t1_;                                           \
+        (h)  = t1_ + t2_;                                     \
+    } while (0)
+
+/* 64 rounds over W + K; words 4g..4g+3 sit at wk[g * stride] */
+#define ROUNDS_BODY(state, wk, stride) do {                                   \
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];      \
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];      \
+        for (int r = 0; r < 16; r += 2) {                                     \
+            const uint32_t *w0 = (wk) + r * (stride);                         \
+            const uint32_t *w1 = w0 + (stride);                               \
+            RND(a, b, c, d, e, f, g, h, w0[0]);                               \
+            RND(h, a, b, c, d, e, f, g, w0[1]);                               \
+            RND(g, h, a, b, c, d, e, f, w0[2]);                               \
+            RND(f, g, h, a, b, c, d, e, w0[3]);                               \
+            RND(e, f, g, h, a, b, c, d, w1[0]);                               \
+            RND(d, e, f, g, h, a, b, c, w1[1]);                               \
+            RND(c, d, e, f, g, h, a, b, w1[2]);                               \
+            RND(b, c, d, e, f, g, h, a, w1[3]);                               \
+        }                                                                     \
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;           \
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;           \
+    } while (0)
+
+static void rounds_plain(uint32_t state[8], const uint32_t *wk, int stride) {
+    ROUNDS_BODY(state, wk, stride);
+}
+
+AVX2_TARGET
+static void rounds_rorx(uint32_t state[8], const uint32_t *wk, int stride) {
+    ROUNDS_BODY(state, wk, stride);
+}
+
+/* ---- 128-bit schedule: one block ---- */
+
+SSSE3_TARGET
+static inline __m128i rotr_x4(__m128i x, int n) {
+    return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+SSSE3_TARGET
+static inline __m128i sig0_x4(__m128i x) {
+    return _mm_xor_si128(_mm_xor_si128(rotr_x4(x, 7), rotr_x4(x, 18)), _mm_srli_epi32(x, 3));
+}
+
+SSSE3_TARGET
+static inline __m128i sig1_x4(__m128i x) {
+    return _mm_xor_si128(_mm_xor_si128(rotr_x4(x, 17), rotr_x4(x, 19)), _mm_srli_epi32(x, 10));
+}
+
+/* x0..x3 = W[t-16..t-1]; replaces x0 with W[t..t+3]. sigma1 needs
+   W[t-2], W[t-1] for the low pair and the fresh low pair for the
+   high pair; shifting zeros into the other half keeps them out. */
+SSSE3_TARGET
+static inline __m128i sched_x4(__m128i x0, __m128i x1, __m128i x2, __m128i x3) {
+    __m128i t = _mm_add_epi32(x0, _mm_alignr_epi8(x3, x2, 4));
+    t = _mm_add_epi32(t, sig0_x4(_mm_alignr_epi8(x1, x0, 4)));
+    t = _mm_add_epi32(t, sig1_x4(_mm_srli_si128(x3, 8)));
+    return _mm_add_epi32(t, sig1_x4(_mm_slli_si128(t, 8)));
+}
+
+#define SCHED_X4(x0, x1, x2, x3, g) do {                                              \
+        x0 = sched_x4(x0, x1, x2, x3);                                                \
+        _mm_store_si128((__m128i *)(wk + 4 * (g)), _mm_add_epi32(x0,                  \
+            _mm_loadu_si128((const __m128i *)(usr_sha256_k + 4 * (g)))));             \
+    } while (0)
+
+SSSE3_TARGET
+static void schedule_x4(const uint8_t block[64], uint32_t wk[64]) {
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+                                       4, 5, 6, 7, 0, 1, 2, 3);
+    __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)block), bswap);
+    __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(block + 16)), bswap);
+    __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(block + 32)), bswap);
+    __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(block + 48)), bswap);
+
+    for (int g = 0; g < 4; g++) {
+        __m128i x = g == 0 ? x0 : g == 1 ? x1 : g == 2 ? x2 : x3;
+        _mm_store_si128((__m128i *)(wk + 4 * g), _mm_add_epi32(x,
+            _mm_loadu_si128((const __m128i *)(usr_sha256_k + 4 * g))));
+    }
+    for (int g = 4; g < 16; g += 4) {
+        SCHED_X4(x0, x1, x2, x3, g);
+        SCHED_X4(x1, x2, x3, x0, g + 1);
+        SCHED_X4(x2, x3, x0, x1, g + 2);
+        SCHED_X4(x3, x0, x1, x2, g + 3);
+    }
+}
+
+SSSE3_TARGET
+void usr_sha256_ssse3_compress(uint32_t state[8], const uint8_t *data, size_t nblocks) {
+    _Alignas(16) uint32_t wk[64];
+    for (; nblocks > 0; nblocks--, data += 64) {
+        schedule_x4(data, wk);
+        rounds_plain(state, wk, 4);
+    }
+}
+
+/* ---- 256-bit schedule: two blocks, one per lane ---- */
+
+AVX2_TARGET
+static inline __m256i rotr_x8(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+AVX2_TARGET
+static inline __m256i sig0_x8(__m256i x) {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr_x8(x, 7), rotr_x8(x, 18)),
+                            _mm256_srli_epi32(x, 3));
+}
+
+AVX2_TARGET
+static inline __m256i sig1_x8(__m256i x) {
+    return _mm256_xor_si256(_mm256_xor_si256(rotr_x8(x, 17), rotr_x8(x, 19)),
+                            _mm256_srli_epi32(x, 10));
+}
+
+AVX2_TARGET
+static inline __m256i sched_x8(__m256i x0, __m256i x1, __m256i x2, __m256i x3) {
+    __m256i t = _mm256_add_epi32(x0, _mm256_alignr_epi8(x3, x2, 4));
+    t = _mm256_add_epi32(t, sig0_x8(_mm256_alignr_epi8(x1, x0, 4)));
+    t = _mm256_add_epi32(t, sig1_x8(_mm256_srli_si256(x3, 8)));
+    return _mm256_add_epi32(t, sig1_x8(_mm256_slli_si256(t, 8)));
+}
+
+/* wk holds group g of both blocks at wk[8g] (block 0) and wk[8g + 4] */
+#define SCHED_X8(x0, x1, x2, x3, g) do {                                              \
+        x0 = sched_x8(x0, x1, x2, x3);                                                \
+        _mm256_store_si256((__m256i *)(wk + 8 * (g)), _mm256_add_epi32(x0,            \
+            _mm256_broadcastsi128_si256(                                              \
+                _mm_loadu_si128((const __m128i *)(usr_sha256_k + 4 * (g))))));        \
+    } while (0)
+
+AVX2_TARGET
+static inline __m256i load_pair(const uint8_t *p0, const uint8_t *p1, __m256i bswap) {
+    __m256i v = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p0));
+    v = _mm256_inserti128_si256(v, _mm_loadu_si128((const __m128i *)p1), 1);
+    return _mm256_shuffle_epi8(v, bswap);
+}
+
+AVX2_TARGET
+static void schedule_x8(const uint8_t *blocks, uint32_t wk[128]) {
+    const __m256i bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+                                          4, 5, 6, 7, 0, 1, 2, 3,
+                                          12, 13, 14, 15, 8, 9, 10, 11,
+                                          4, 5, 6, 7, 0, 1, 2, 3);
+    __m256i x0 = load_pair(blocks,      blocks + 64,  bswap);
+    __m256i x1 = load_pair(blocks + 16, blocks + 80,  bswap);
+    __m256i x2 = load_pair(blocks + 32, blocks + 96,  bswap);
+    __m256i x3 = load_pair(blocks + 48, blocks + 112, bswap);
+
+    for (int g = 0; g < 4; g++) {
+        __m256i x = g == 0 ? x0 : g == 1 ? x1 : g == 2 ? x2 : x3;
+        _mm256_store_si256((__m256i *)(wk + 8 * g), _mm256_add_epi32(x,
+            _mm256_broadcastsi128_si256(
+                _mm_loadu_si128((const __m128i *)(usr_sha256_k + 4 * g)))));
+    }
+    for (int g = 4; g < 16; g += 4) {
+        SCHED_X8(x0, x1, x2, x3, g);
+        SCHED_X8(x1, x2, x3, x0, g + 1);
+        SCHED_X8(x2, x3, x0, x1, g + 2);
+        SCHED_X8(x3, x0, x1, x2, g + 3);
+    }
+}
+
+AVX2_TARGET
+void usr_sha256_avx2_compress(uint32_t state[8], const uint8_t *data, size_t nblocks) {
+    _Alignas(32) uint32_t wk[128];
+    for (; nblocks >= 2; nblocks -= 2, data += 128) {
+        schedule_x8(data, wk);
+        rounds_rorx(state, wk, 8);
+        rounds_rorx(state, wk + 4, 8);
+    }
+    if (nblocks) {
+        schedule_x4(data, wk);
+        rounds_rorx(state, wk, 4);
+    }
+}
+
+int usr_sha256_simd_compiled(void) { return 1; }
+
+#else /* !USR_X86 */
+
+/* Never selected: usr_sha256_simd_compiled() reports them as unavailable. */
+void usr_sha256_ssse3_compress(uint32_t state[8], const uint8_t *data, size_t nblocks) {
+    (void)state; (void)data; (void)nblocks;
+}
+
+void usr_sha256_avx2_compress(uint32_t state[8], const uint8_t *data, size_t nblocks) {
+    (void)state; (void)data; (void)nblocks;
+}
+
+int usr_sha256_simd_compiled(void) { return 0; }
+
+#endif
@@ -1,9 +1,11 @@
 #include "usr/crypto.h"
+#include "sha_impl.h"
+#include "cpu_features.h"
 #include <string.h>
 #include <stdint.h>
 
 /* SHA-512 round constants (first 64 bits of fractional parts of cube roots of first 80 primes) */
-static const uint64_t K512[80] = {
+const uint64_t usr_sha512_k[80] = {
     0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL,
     0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
     0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
@@ -62,7 +64,7 @@ static const uint64_t H512[8] = {
 #define SIG0_64(x)   (ROTR64(x, 1) ^ ROTR64(x, 8) ^ ((x) >> 7))
 #define SIG1_64(x)   (ROTR64(x,19) ^ ROTR64(x,61) ^ ((x) >> 6))
 
-static void sha512_compress(uint64_t state[8], const uint8_t block[128]) {
+static void sha512_compress_block(uint64_t state[8], const uint8_t block[128]) {
     uint64_t w[80];
     int i;
 
@@ -80,7 +82,7 @@ static void sha512_compress(uint64_t state[8], const uint8_t block[128]) {
     uint64_t e=state[4], f=state[5], g=state[6], h=state[7];
 
     for (i = 0; i < 80; i++) {
-        uint64_t t1 = h + EP1_64(e) + CH64(e,f,g) + K512[i] + w[i];
+        uint64_t t1 = h + EP1_64(e) + CH64(e,f,g) + usr_sha512_k[i] + w[i];
         uint64_t t2 = EP0_64(a) + MAJ64(a,b,c);
         h=g; g=f; f=e; e=d+t1;
         d=c; c=b; b=a; a=t1+t2;
@@ -90,6 +92,23 @@ static void sha512_compress(uint64_t state[8], const uint8_t block[128]) {
     state[4]+=e; state[5]+=f; state[6]+=g; state[7]+=h;
 }
 
+/* Process `nblocks` consecutive 128-byte blocks */
+void usr_sha512_compress(uint64_t state[8], const uint8_t *data, size_t nblocks) {
+    if (usr_sha512_simd_compiled()) {
+        if (usr_cpu_has(USR_CPU_AVX2 | USR_CPU_BMI2)) {
+            usr_sha512_avx2_compress(state, data, nblocks);
+            return;
+        }
+        if (usr_cpu_has(USR_CPU_SSSE3)) {
+            usr_sha512_ssse3_compress(state, data, nblocks);
+            return;
+        }
+    }
+    for (size_t i = 0; i < nblocks; i++) {
+        sha512_compress_block(state, data + 128 * i);
+    }
+}
+
 void usr_sha512_init(usr_sha512_ctx *ctx) {
     for (int i = 0; i < 8; i++) ctx->state[i] = H512[i];
     ctx->bitcount_hi = 0;
@@ -114,14 +133,15 @@ void usr_sha512_update(usr_sha512_ctx *ctx, const uint8_t *data, size_t len) {
         ctx->buflen += (uint32_t)fill;
         i += fill;
         if (ctx->buflen == 128) {
-            sha512_compress(ctx->state, ctx->buf);
+            usr_sha512_compress(ctx->state, ctx->buf, 1);
             ctx->buflen = 0;
         }
     }
 
-    while (i + 128 <= len) {
-        sha512_compress(ctx->state, data + i);
-        i += 128;
+    if (len - i >= 128) {
+        size_t nblocks = (len - i) / 128;
+        usr_sha512_compress(ctx->state, data + i, nblocks);
+        i += nblocks * 128;
     }
 
     if (i < len) {
@@ -142,7 +162,7 @@ void usr_sha512_final(usr_sha512_ctx *ctx, uint8_t out[64]) {
 
     if (buflen > 112) {
         memset(ctx->buf + buflen, 0, 128 - buflen);
-        sha512_compress(ctx->state, ctx->buf);
+        usr_sha512_compress(ctx->state, ctx->buf, 1);
         buflen = 0;
     }
 
@@ -151,7 +171,7 @@ void usr_sha512_final(usr_sha512_ctx *ctx, uint8_t out[64]) {
     /* Write 128-bit bit count big-endian */
     for (int i = 0; i < 8; i++) ctx->buf[112+i] = (uint8_t)(bitcount_hi >> (56 - i*8));
     for (int i = 0; i < 8; i++) ctx->buf[120+i] = (uint8_t)(bitcount_lo >> (56 - i*8));
-    sha512_compress(ctx->state, ctx->buf);
+    usr_sha512_compress(ctx->state, ctx->buf, 1);
 
     for (int i = 0; i < 8; i++) {
         out[i*8  ] = (uint8_t)(ctx->state[i] >> 56);
@@ -167,6 +187,63 @@ void usr_sha512_final(usr_sha512_ctx *ctx, uint8_t out[64]) {
     memset(ctx, 0, sizeof(*ctx));
 }
 
+/* ============================================================
+   Midstate export / import / clone
+   Layout (USR_SHA512_EXPORT_SIZE bytes, all integers big-endian):
+     [0..3]     'u' 's' 0x40 version
+     [4..67]    state words
+     [68..83]   message length in bits (128-bit)
+     [84]       buffered bytes (< 128)
+     [85..212]  buffer, zero past the buffered bytes
+   ============================================================ */
+
+#define SHA512_EXPORT_VERSION 1
+
+int usr_sha512_export(const usr_sha512_ctx *ctx, uint8_t out[USR_SHA512_EXPORT_SIZE]) {
+    if (!ctx || !out || ctx->buflen >= 128) return -1;
+
+    uint8_t *p = out;
+    *p++ = 'u'; *p++ = 's'; *p++ = 0x40; *p++ = SHA512_EXPORT_VERSION;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) *p++ = (uint8_t)(ctx->state[i] >> (56 - 8 * j));
+    }
+    for (int j = 0; j < 8; j++) *p++ = (uint8_t)(ctx->bitcount_hi >> (56 - 8 * j));
+    for (int j = 0; j < 8; j++) *p++ = (uint8_t)(ctx->bitcount_lo >> (56 - 8 * j));
+    *p++ = (uint8_t)ctx->buflen;
+    memcpy(p, ctx->buf, ctx->buflen);
+    memset(p + ctx->buflen, 0, 128 - ctx->buflen);
+    return 0;
+}
+
+int usr_sha512_import(usr_sha512_ctx *ctx, const uint8_t in[USR_SHA512_EXPORT_SIZE]) {
+    if (!ctx || !in) return -1;
+    if (in[0] != 'u' || in[1] != 's' || in[2] != 0x40 || in[3] != SHA512_EXPORT_VERSION) return -1;
+
+    const uint8_t *p = in + 4;
+    uint64_t hi = 0, lo = 0;
+    for (int j = 0; j < 8; j++) hi = (hi << 8) | p[64 + j];
+    for (int j = 0; j < 8; j++) lo = (lo << 8) | p[72 + j];
+    uint32_t buflen = p[80];
+    /* The buffer holds exactly the bytes past the last whole block */
+    if (buflen >= 128 || (lo & 7) || (lo >> 3) % 128 != buflen) return -1;
+
+    for (int i = 0; i < 8; i++) {
+        uint64_t w = 0;
+        for (int j = 0; j < 8; j++) w = (w << 8) | p[i*8 + j];
+        ctx->state[i] = w;
+    }
+    ctx->bitcount_hi = hi;
+    ctx->bitcount_lo = lo;
+    ctx->buflen      = buflen;
+    memcpy(ctx->buf, p + 81, buflen);
+    memset(ctx->buf + buflen, 0, 128 - buflen);
+    return 0;
+}
+
+void usr_sha512_clone(usr_sha512_ctx *dst, const usr_sha512_ctx *src) {
+    if (dst && src) *dst = *src;
+}
+
 void usr_sha512(const uint8_t *data, size_t len, uint8_t out[64]) {
     usr_sha512_ctx ctx;
     usr_sha512_init(&ctx);
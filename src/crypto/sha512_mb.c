@@ -0,0 +1,122 @@
+#include "sha_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+
+/* ============================================================
+   Multi-lane SHA-512 compression
+
+   The 64-bit counterpart of the sha256_mb.c kernels: one stream per
+   64-bit lane, 4 lanes with AVX2 and 8 with AVX-512. There is no
+   SHA-512 instruction to compete with, so even 4 AVX2 lanes beat
+   the single-stream AVX2 schedule.
+   ============================================================ */
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define AVX2_TARGET   USR_TARGET("avx2")
+#define AVX512_TARGET USR_TARGET("avx512f")
+
+/* 80 rounds shared by both kernels; same macro set as sha256_mb.c */
+#define MB512_COMPRESS(LANES)                                                   \
+    V w[16];                                                                    \
+    for (int j = 0; j < 16; j++) w[j] = LOAD(wt + j * LANES);                   \
+                                                                                \
+    V a = LOAD(st),             b = LOAD(st + LANES);                           \
+    V c = LOAD(st + 2 * LANES), d = LOAD(st + 3 * LANES);                       \
+    V e = LOAD(st + 4 * LANES), f = LOAD(st + 5 * LANES);                       \
+    V g = LOAD(st + 6 * LANES), h = LOAD(st + 7 * LANES);                       \
+                                                                                \
+    for (int i = 0; i < 80; i++) {                                              \
+        if (i >= 16) {                                                          \
+            V w2 = w[(i - 2) & 15], w15 = w[(i - 15) & 15];                     \
+            V s0 = XOR3(ROTR(w15, 1), ROTR(w15, 8), SHR(w15, 7));               \
+            V s1 = XOR3(ROTR(w2, 19), ROTR(w2, 61), SHR(w2, 6));                \
+            w[i & 15] = ADD(ADD(w[i & 15], s0), ADD(w[(i - 7) & 15], s1));      \
+        }                                                                       \
+        V t1 = ADD(ADD(h, XOR3(ROTR(e, 14), ROTR(e, 18), ROTR(e, 41))),         \
+                   ADD(CH(e, f, g), ADD(SET1(usr_sha512_k[i]), w[i & 15])));    \
+        V t2 = ADD(XOR3(ROTR(a, 28), ROTR(a, 34), ROTR(a, 39)), MAJ(a, b, c));  \
+        h = g; g = f; f = e; e = ADD(d, t1);                                    \
+        d = c; c = b; b = a; a = ADD(t1, t2);                                   \
+    }                                                                           \
+                                                                                \
+    STORE(st,             ADD(a, LOAD(st)));                                    \
+    STORE(st + LANES,     ADD(b, LOAD(st + LANES)));                            \
+    STORE(st + 2 * LANES, ADD(c, LOAD(st + 2 * LANES)));                        \
+    STORE(st + 3 * LANES, ADD(d, LOAD(st + 3 * LANES)));                        \
+    STORE(st + 4 * LANES, ADD(e, LOAD(st + 4 * LANES)));                        \
+    STORE(st + 5 * LANES, ADD(f, LOAD(st + 5 * LANES)));                        \
+    STORE(st + 6 * LANES, ADD(g, LOAD(st + 6 * LANES)));                        \
+    STORE(st + 7 * LANES, ADD(h, LOAD(st + 7 * LANES)))
+
+/* ---- AVX2: 4 lanes ---- */
+
+#define V          __m256i
+#define ADD        _mm256_add_epi64
+#define SHR        _mm256_srli_epi64
+#define SET1(k)    _mm256_set1_epi64x((long long)(k))
+#define LOAD(p)    _mm256_load_si256((const __m256i *)(p))
+#define STORE(p,v) _mm256_store_si256((__m256i *)(p), (v))
+#define ROTR(x,n)  _mm256_or_si256(_mm256_srli_epi64((x), (n)), _mm256_slli_epi64((x), 64 - (n)))
+#define XOR3(x,y,z) _mm256_xor_si256(_mm256_xor_si256((x), (y)), (z))
+#define CH(x,y,z)  _mm256_xor_si256(_mm256_and_si256((x), (y)), _mm256_andnot_si256((x), (z)))
+#define MAJ(x,y,z) _mm256_or_si256(_mm256_and_si256((x), (y)), \
+                                   _mm256_and_si256((z), _mm256_or_si256((x), (y))))
+
+AVX2_TARGET
+static void sha512_x4_avx2(uint64_t *st, const uint64_t *wt) {
+    MB512_COMPRESS(4);
+}
+
+#undef V
+#undef ADD
+#undef SHR
+#undef SET1
+#undef LOAD
+#undef STORE
+#undef ROTR
+#undef XOR3
+#undef CH
+#undef MAJ
+
+/* ---- AVX-512: 8 lanes ---- */
+
+#define V          __m512i
+#define ADD        _mm512_add_epi64
+#define SHR        _mm512_srli_epi64
+#define SET1(k)    _mm512_set1_epi64((long long)(k))
+#define LOAD(p)    _mm512_load_si512((const void *)(p))
+#define STORE(p,v) _mm512_store_si512((void *)(p), (v))
+#define ROTR(x,n)  _mm512_ror_epi64((x), (n))
+#define XOR3(x,y,z) _mm512_ternarylogic_epi64((x), (y), (z), 0x96)
+#define CH(x,y,z)  _mm512_ternarylogic_epi64((x), (y), (z), 0xCA)
+#define MAJ(x,y,z) _mm512_ternarylogic_epi64((x), (y), (z), 0xE8)
+
+AVX512_TARGET
+static void sha512_x8_avx512(uint64_t *st, const uint64_t *wt) {
+    MB512_COMPRESS(8);
+}
+
+#undef V
+#undef ADD
+#undef SHR
+#undef SET1
+#undef LOAD
+#undef STORE
+#undef ROTR
+#undef XOR3
+#undef CH
+#undef MAJ
+
+#endif /* USR_X86 */
+
+usr_sha512_lanes_fn usr_sha512_lanes_select(int *lanes) {
+#if USR_X86
+    if (usr_cpu_has(USR_CPU_AVX512F)) { *lanes = 8; return sha512_x8_avx512; }
+    if (usr_cpu_has(USR_CPU_AVX2))    { *lanes = 4; return sha512_x4_avx2; }
+#endif
+    *lanes = 1;
+    return NULL;
+}
@@ -0,0 +1,203 @@
+#include "sha_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+
+/* ============================================================
+   SHA-512 with a vectorised message schedule (SSSE3 / AVX2)
+
+   Same layout as sha256_simd.c with 64-bit words: a vector holds
+   two schedule words, and every pair depends only on the pair
+   before it, so no lane masking is needed. The AVX2 kernel
+   expands two blocks at once, one per 128-bit lane, and runs its
+   rounds with BMI2 (RORX).
+   ============================================================ */
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define SSSE3_TARGET USR_TARGET("ssse3,sse2")
+#define AVX2_TARGET  USR_TARGET("avx2,bmi2")
+
+#define ROTR64(x, n)  (((x) >> (n)) | ((x) << (64 - (n))))
+#define EP0(x)        (ROTR64(x, 28) ^ ROTR64(x, 34) ^ ROTR64(x, 39))
+#define EP1(x)        (ROTR64(x, 14) ^ ROTR64(x, 18) ^ ROTR64(x, 41))
+#define CH(x, y, z)   (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)  (((x) & (y)) | ((z) & ((x) | (y))))
+
+#define RND(a, b, c, d, e, f, g, h, wk) do {                  \
+        uint64_t t1_ = (h) + EP1(e) + CH(e, f, g) + (wk);     \
+        uint64_t t2_ = EP0(a) + MAJ(a, b, c);                 \
+        (d) += t1_;                                           \
+        (h)  = t1_ + t2_;                                     \
+    } while (0)
+
+/* 80 rounds over W + K; words 2g, 2g+1 sit at wk[g * stride] */
+#define ROUNDS_BODY(state, wk, stride) do {                                   \
+        uint64_t a = state[0], b = state[1], c = state[2], d = state[3];      \
+        uint64_t e = state[4], f = state[5], g = state[6], h = state[7];      \
+        for (int r = 0; r < 40; r += 4) {                                     \
+            const uint64_t *w = (wk) + r * (stride);                          \
+            RND(a, b, c, d, e, f, g, h, w[0]);                                \
+            RND(h, a, b, c, d, e, f, g, w[1]);                                \
+            w += (stride);                                                    \
+            RND(g, h, a, b, c, d, e, f, w[0]);                                \
+            RND(f, g, h, a, b, c, d, e, w[1]);                                \
+            w += (stride);                                                    \
+            RND(e, f, g, h, a, b, c, d, w[0]);                                \
+            RND(d, e, f, g, h, a, b, c, w[1]);                                \
+            w += (stride);                                                    \
+            RND(c, d, e, f, g, h, a, b, w[0]);                                \
+            RND(b, c, d, e, f, g, h, a, w[1]);                                \
+        }                                                                     \
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;           \
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;           \
+    } while (0)
+
+static void rounds_plain(uint64_t state[8], const uint64_t *wk, int stride) {
+    ROUNDS_BODY(state, wk, stride);
+}
+
+AVX2_TARGET
+static void rounds_rorx(uint64_t state[8], const uint64_t *wk, int stride) {
+    ROUNDS_BODY(state, wk, stride);
+}
+
+/* ---- 128-bit schedule: one block ---- */
+
+SSSE3_TARGET
+static inline __m128i rotr_x2(__m128i x, int n) {
+    return _mm_or_si128(_mm_srli_epi64(x, n), _mm_slli_epi64(x, 64 - n));
+}
+
+/* P[k] = sigma1(P[k-1]) + W[t-7..t-6] + sigma0(W[t-15..t-14]) + P[k-8],
+   with p8 = P[k-8], p7 = P[k-7], p4 = P[k-4], p3 = P[k-3], p1 = P[k-1] */
+SSSE3_TARGET
+static inline __m128i sched_x2(__m128i p8, __m128i p7, __m128i p4, __m128i p3, __m128i p1) {
+    __m128i w15 = _mm_alignr_epi8(p7, p8, 8);
+    __m128i s0  = _mm_xor_si128(_mm_xor_si128(rotr_x2(w15, 1), rotr_x2(w15, 8)),
+                                _mm_srli_epi64(w15, 7));
+    __m128i s1  = _mm_xor_si128(_mm_xor_si128(rotr_x2(p1, 19), rotr_x2(p1, 61)),
+                                _mm_srli_epi64(p1, 6));
+    __m128i t   = _mm_add_epi64(p8, _mm_alignr_epi8(p3, p4, 8));
+    return _mm_add_epi64(_mm_add_epi64(t, s0), s1);
+}
+
+#define SCHED_X2(p8, p7, p4, p3, p1, g) do {                                          \
+        p8 = sched_x2(p8, p7, p4, p3, p1);                                            \
+        _mm_store_si128((__m128i *)(wk + 2 * (g)), _mm_add_epi64(p8,                  \
+            _mm_loadu_si128((const __m128i *)(usr_sha512_k + 2 * (g)))));             \
+    } while (0)
+
+/* Eight new pairs; x_i holds P[k] for k = i (mod 8) */
+#define SCHED_RING(SCHED, g) do {                         \
+        SCHED(x0, x1, x4, x5, x7, (g));                   \
+        SCHED(x1, x2, x5, x6, x0, (g) + 1);               \
+        SCHED(x2, x3, x6, x7, x1, (g) + 2);               \
+        SCHED(x3, x4, x7, x0, x2, (g) + 3);               \
+        SCHED(x4, x5, x0, x1, x3, (g) + 4);               \
+        SCHED(x5, x6, x1, x2, x4, (g) + 5);               \
+        SCHED(x6, x7, x2, x3, x5, (g) + 6);               \
+        SCHED(x7, x0, x3, x4, x6, (g) + 7);               \
+    } while (0)
+
+SSSE3_TARGET
+static void schedule_x2(const uint8_t block[128], uint64_t wk[80]) {
+    const __m128i bswap = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+                                       0, 1, 2, 3, 4, 5, 6, 7);
+    __m128i x[8];
+    for (int g = 0; g < 8; g++) {
+        x[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(block + 16 * g)), bswap);
+        _mm_store_si128((__m128i *)(wk + 2 * g), _mm_add_epi64(x[g],
+            _mm_loadu_si128((const __m128i *)(usr_sha512_k + 2 * g))));
+    }
+    __m128i x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3];
+    __m128i x4 = x[4], x5 = x[5], x6 = x[6], x7 = x[7];
+    for (int g = 8; g < 40; g += 8) SCHED_RING(SCHED_X2, g);
+}
+
+SSSE3_TARGET
+void usr_sha512_ssse3_compress(uint64_t state[8], const uint8_t *data, size_t nblocks) {
+    _Alignas(16) uint64_t wk[80];
+    for (; nblocks > 0; nblocks--, data += 128) {
+        schedule_x2(data, wk);
+        rounds_plain(state, wk, 2);
+    }
+}
+
+/* ---- 256-bit schedule: two blocks, one per lane ---- */
+
+AVX2_TARGET
+static inline __m256i rotr_x4(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n));
+}
+
+AVX2_TARGET
+static inline __m256i sched_x4(__m256i p8, __m256i p7, __m256i p4, __m256i p3, __m256i p1) {
+    __m256i w15 = _mm256_alignr_epi8(p7, p8, 8);
+    __m256i s0  = _mm256_xor_si256(_mm256_xor_si256(rotr_x4(w15, 1), rotr_x4(w15, 8)),
+                                   _mm256_srli_epi64(w15, 7));
+    __m256i s1  = _mm256_xor_si256(_mm256_xor_si256(rotr_x4(p1, 19), rotr_x4(p1, 61)),
+                                   _mm256_srli_epi64(p1, 6));
+    __m256i t   = _mm256_add_epi64(p8, _mm256_alignr_epi8(p3, p4, 8));
+    return _mm256_add_epi64(_mm256_add_epi64(t, s0), s1);
+}
+
+/* wk holds pair g of both blocks at wk[4g] (block 0) and wk[4g + 2] */
+#define SCHED_X4(p8, p7, p4, p3, p1, g) do {                                          \
+        p8 = sched_x4(p8, p7, p4, p3, p1);                                            \
+        _mm256_store_si256((__m256i *)(wk + 4 * (g)), _mm256_add_epi64(p8,            \
+            _mm256_broadcastsi128_si256(                                              \
+                _mm_loadu_si128((const __m128i *)(usr_sha512_k + 2 * (g))))));        \
+    } while (0)
+
+AVX2_TARGET
+static void schedule_x4(const uint8_t *blocks, uint64_t wk[160]) {
+    const __m256i bswap = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+                                          0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15,
+                                          0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i x[8];
+    for (int g = 0; g < 8; g++) {
+        __m256i v = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(blocks + 16 * g)));
+        v = _mm256_inserti128_si256(v, _mm_loadu_si128((const __m128i *)(blocks + 128 + 16 * g)), 1);
+        x[g] = _mm256_shuffle_epi8(v, bswap);
+        _mm256_store_si256((__m256i *)(wk + 4 * g), _mm256_add_epi64(x[g],
+            _mm256_broadcastsi128_si256(
+                _mm_loadu_si128((const __m128i *)(usr_sha512_k + 2 * g)))));
+    }
+    __m256i x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3];
+    __m256i x4 = x[4], x5 = x[5], x6 = x[6], x7 = x[7];
+    for (int g = 8; g < 40; g += 8) SCHED_RING(SCHED_X4, g);
+}
+
+AVX2_TARGET
+void usr_sha512_avx2_compress(uint64_t state[8], const uint8_t *data, size_t nblocks) {
+    _Alignas(32) uint64_t wk[160];
+    for (; nblocks >= 2; nblocks -= 2, data += 256) {
+        schedule_x4(data, wk);
+        rounds_rorx(state, wk, 4);
+        rounds_rorx(state, wk + 2, 4);
+    }
+    if (nblocks) {
+        schedule_x2(data, wk);
+        rounds_rorx(state, wk, 2);
+    }
+}
+
+int usr_sha512_simd_compiled(void) { return 1; }
+
+#else /* !USR_X86 */
+
+/* Never selected: usr_sha512_simd_compiled() reports them as unavailable. */
+void usr_sha512_ssse3_compress(uint64_t state[8], const uint8_t *data, size_t nblocks) {
+    (void)state; (void)data; (void)nblocks;
+}
+
+void usr_sha512_avx2_compress(uint64_t state[8], const uint8_t *data, size_t nblocks) {
+    (void)state; (void)data; (void)nblocks;
+}
+
+int usr_sha512_simd_compiled(void) { return 0; }
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef USR_SHA_IMPL_H
+#define USR_SHA_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+   Internal SHA-2 kernels shared between the portable code and
+   the CPU-specific implementations.
+   ============================================================ */
+
+/* Round constants (sha256.c, sha512.c) */
+extern const uint32_t usr_sha256_k[64];
+extern const uint64_t usr_sha512_k[80];
+
+/* SHA-1 (sha1.c, sha1_shani.c), same contract as the SHA-256
+   kernels below; SHA-NI needs USR_CPU_SHA | USR_CPU_SSE41. */
+void usr_sha1_compress(uint32_t state[5], const uint8_t *data, size_t nblocks);
+void usr_sha1_shani_compress(uint32_t state[5], const uint8_t *data, size_t nblocks);
+int  usr_sha1_shani_compiled(void);
+
+/* Compress `nblocks` consecutive 64-byte blocks into `state` with the
+   fastest kernel for this CPU (sha256.c). */
+void usr_sha256_compress(uint32_t state[8], const uint8_t *data, size_t nblocks);
+
+/* Same for 128-byte SHA-512 blocks (sha512.c) */
+void usr_sha512_compress(uint64_t state[8], const uint8_t *data, size_t nblocks);
+
+/* SHA-NI (sha256_shani.c): compress `nblocks` consecutive 64-byte
+   blocks into `state`. Only usable when usr_cpu_has(USR_CPU_SHA |
+   USR_CPU_SSE41) and usr_sha256_shani_compiled(). */
+void usr_sha256_shani_compress(uint32_t state[8], const uint8_t *data, size_t nblocks);
+int  usr_sha256_shani_compiled(void);
+
+/* Vectorised message schedule (sha256_simd.c, sha512_simd.c), same
+   contract as above. SSSE3 needs USR_CPU_SSSE3; AVX2 needs
+   USR_CPU_AVX2 | USR_CPU_BMI2. */
+void usr_sha256_ssse3_compress(uint32_t state[8], const uint8_t *data, size_t nblocks);
+void usr_sha256_avx2_compress(uint32_t state[8], const uint8_t *data, size_t nblocks);
+int  usr_sha256_simd_compiled(void);
+
+void usr_sha512_ssse3_compress(uint64_t state[8], const uint8_t *data, size_t nblocks);
+void usr_sha512_avx2_compress(uint64_t state[8], const uint8_t *data, size_t nblocks);
+int  usr_sha512_simd_compiled(void);
+
+/* Multi-lane kernels (sha256_mb.c, sha512_mb.c): compress one block
+   in each of `lanes` independent streams. Both arrays are transposed
+   and 64-byte aligned: state word i of lane l at st[i * lanes + l],
+   message word j (already big-endian decoded) at wt[j * lanes + l].
+   _select() returns the widest kernel for this CPU, or NULL with
+   *lanes = 1 when there is none. */
+typedef void (*usr_sha256_lanes_fn)(uint32_t *st, const uint32_t *wt);
+typedef void (*usr_sha512_lanes_fn)(uint64_t *st, const uint64_t *wt);
+
+usr_sha256_lanes_fn usr_sha256_lanes_select(int *lanes);
+usr_sha512_lanes_fn usr_sha512_lanes_select(int *lanes);
+
+#endif /* USR_SHA_IMPL_H */
@@ -0,0 +1,32 @@
+#ifndef USR_BASE64_IMPL_H
+#define USR_BASE64_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+   Internal SIMD Base64 kernels (base64_simd.c).
+
+   Each kernel handles whole blocks from the start of its input and
+   returns how many input bytes it consumed; encoding.c finishes the
+   rest with the scalar code. Only usable when
+   usr_base64_simd_compiled() and the CPU has the named extension.
+   ============================================================ */
+
+/* Encode 12 (SSSE3) or 24 (AVX2) bytes per step. Consumes a multiple
+   of 3 bytes and writes 4 characters per 3 bytes; url selects the
+   URL-safe alphabet. No NUL is written. */
+size_t usr_base64_encode_ssse3(const uint8_t *in, size_t in_len, char *out, int url);
+size_t usr_base64_encode_avx2(const uint8_t *in, size_t in_len, char *out, int url);
+
+/* Decode 16 (SSSE3) or 32 (AVX2) characters per step, stopping at the
+   first block holding anything but alphabet characters (padding,
+   whitespace, invalid bytes). Both alphabets are accepted, as in the
+   scalar decoder. Consumes a multiple of 4 characters and writes
+   exactly 3 bytes per 4 characters. */
+size_t usr_base64_decode_ssse3(const char *in, size_t in_len, uint8_t *out);
+size_t usr_base64_decode_avx2(const char *in, size_t in_len, uint8_t *out);
+
+int usr_base64_simd_compiled(void);
+
+#endif /* USR_BASE64_IMPL_H */
@@ -0,0 +1,220 @@
+#include "base64_impl.h"
+#include "cpu_features.h"
+#include <stdint.h>
+#include <string.h>
+
+/* ============================================================
+   SIMD Base64 (W. Muła and D. Lemire, "Faster Base64 Encoding and
+   Decoding Using AVX2 Instructions", 2018)
+
+   Encode: PSHUFB spreads each 3-byte group over a 32-bit lane, two
+   multiplies shift the four 6-bit fields into separate bytes, and a
+   second PSHUFB maps each field's range to its ASCII offset.
+
+   Decode: two PSHUFB lookups on the low and high nibbles check that
+   every character is in the alphabet (the union of standard and
+   URL-safe, like the scalar table); any block with something else
+   stops the kernel so the scalar decoder can handle whitespace,
+   padding and errors. A third lookup on the high nibble gives each
+   character's offset, with compares fixing up the four symbols that
+   share a nibble range with other characters. Two multiply-adds
+   then pack four 6-bit values into three bytes.
+
+   The AVX2 kernels run the same steps in each 128-bit half.
+   ============================================================ */
+
+#if USR_X86
+
+#include <immintrin.h>
+
+#define SSSE3_TARGET USR_TARGET("ssse3")
+#define AVX2_TARGET  USR_TARGET("avx2")
+
+/* Offset added to a 6-bit value, indexed by (value - 51, saturated),
+   with 13 for values below 26 */
+#define ENC_LUT(c62, c63)                                                   \
+    71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, (c62) - 62, (c63) - 63, 65, 0, 0
+
+/* Byte order within each 3-byte group, as 16-bit halves for the
+   multiplies: [b1 b0 b2 b1] */
+#define ENC_SHUF 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+
+/* Decode classes: a character is valid iff
+   DEC_LO[c & 15] & DEC_HI[c >> 4] == 0. Bit 0: '+' '-' '/'; bit 1:
+   digits; bit 2: 'A'-'O' and 'a'-'o'; bit 3: 'P'-'Z' and '_';
+   bit 4: 'p'-'z'; bit 7: never valid */
+#define DEC_LO 0x85, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, \
+               0x81, 0x81, 0x83, 0x9a, 0x9b, 0x9a, 0x9b, 0x92
+#define DEC_HI 0x80, 0x80, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, \
+               0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+/* Offset by high nibble ('+' for 0x2_, fixed up for '-' '/' '_') */
+#define DEC_OFF 0, 0, 62 - '+', 52 - '0', -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+#define FIX_MINUS ((62 - '-') - (62 - '+'))
+#define FIX_SLASH ((63 - '/') - (62 - '+'))
+#define FIX_UNDER ((63 - '_') + 65)
+
+/* Packed 3-byte groups back to memory order; lanes 12..15 unused */
+#define DEC_SHUF 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+/* ---- SSSE3: 16 characters per step ---- */
+
+SSSE3_TARGET
+static inline __m128i enc_fields_128(__m128i v) {
+    v = _mm_shuffle_epi8(v, _mm_setr_epi8(ENC_SHUF));
+    __m128i hi = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)),
+                                 _mm_set1_epi32(0x04000040));
+    __m128i lo = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)),
+                                 _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(hi, lo);
+}
+
+SSSE3_TARGET
+static inline __m128i enc_ascii_128(__m128i idx, __m128i lut) {
+    __m128i r = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+    r = _mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(idx, _mm_shuffle_epi8(lut, r));
+}
+
+SSSE3_TARGET
+size_t usr_base64_encode_ssse3(const uint8_t *in, size_t in_len, char *out, int url) {
+    const __m128i lut = url ? _mm_setr_epi8(ENC_LUT('-', '_'))
+                            : _mm_setr_epi8(ENC_LUT('+', '/'));
+    size_t i = 0;
+    /* 12 bytes used per 16-byte load */
+    for (; i + 16 <= in_len; i += 12, out += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        _mm_storeu_si128((__m128i *)out, enc_ascii_128(enc_fields_128(v), lut));
+    }
+    return i;
+}
+
+SSSE3_TARGET
+size_t usr_base64_decode_ssse3(const char *in, size_t in_len, uint8_t *out) {
+    const __m128i lut_lo = _mm_setr_epi8(DEC_LO), lut_hi = _mm_setr_epi8(DEC_HI);
+    const __m128i lut_off = _mm_setr_epi8(DEC_OFF);
+    const __m128i nib = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= in_len; i += 16, out += 12) {
+        __m128i c  = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi32(c, 4), nib);
+        __m128i lo = _mm_and_si128(c, nib);
+
+        __m128i bad = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo), _mm_shuffle_epi8(lut_hi, hi));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(bad, _mm_setzero_si128())) != 0xFFFF) break;
+
+        __m128i off = _mm_shuffle_epi8(lut_off, hi);
+        off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('-')),
+                                              _mm_set1_epi8(FIX_MINUS)));
+        off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('/')),
+                                              _mm_set1_epi8(FIX_SLASH)));
+        off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('_')),
+                                              _mm_set1_epi8(FIX_UNDER)));
+        __m128i v = _mm_add_epi8(c, off);
+
+        /* [00aaaaaa 00bbbbbb 00cccccc 00dddddd] -> 24 bits per lane */
+        v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+        v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+        v = _mm_shuffle_epi8(v, _mm_setr_epi8(DEC_SHUF));
+
+        /* Exactly 12 bytes: the output buffer has no slack */
+        uint32_t tail = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+        _mm_storel_epi64((__m128i *)out, v);
+        memcpy(out + 8, &tail, 4);
+    }
+    return i;
+}
+
+/* ---- AVX2: 32 characters per step ---- */
+
+AVX2_TARGET
+size_t usr_base64_encode_avx2(const uint8_t *in, size_t in_len, char *out, int url) {
+    const __m256i lut = url ? _mm256_setr_epi8(ENC_LUT('-', '_'), ENC_LUT('-', '_'))
+                            : _mm256_setr_epi8(ENC_LUT('+', '/'), ENC_LUT('+', '/'));
+    const __m256i shuf = _mm256_setr_epi8(ENC_SHUF, ENC_SHUF);
+    size_t i = 0;
+    /* Two overlapping 16-byte loads, 12 bytes used from each */
+    for (; i + 28 <= in_len; i += 24, out += 32) {
+        __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(in + i))),
+            _mm_loadu_si128((const __m128i *)(in + i + 12)), 1);
+        v = _mm256_shuffle_epi8(v, shuf);
+        __m256i hi = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)),
+                                        _mm256_set1_epi32(0x04000040));
+        __m256i lo = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)),
+                                        _mm256_set1_epi32(0x01000010));
+        __m256i idx = _mm256_or_si256(hi, lo);
+
+        __m256i r = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+        __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+        r = _mm256_or_si256(r, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        _mm256_storeu_si256((__m256i *)out, _mm256_add_epi8(idx, _mm256_shuffle_epi8(lut, r)));
+    }
+    return i;
+}
+
+AVX2_TARGET
+size_t usr_base64_decode_avx2(const char *in, size_t in_len, uint8_t *out) {
+    const __m256i lut_lo  = _mm256_setr_epi8(DEC_LO, DEC_LO);
+    const __m256i lut_hi  = _mm256_setr_epi8(DEC_HI, DEC_HI);
+    const __m256i lut_off = _mm256_setr_epi8(DEC_OFF, DEC_OFF);
+    const __m256i shuf    = _mm256_setr_epi8(DEC_SHUF, DEC_SHUF);
+    const __m256i nib     = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= in_len; i += 32, out += 24) {
+        __m256i c  = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi32(c, 4), nib);
+        __m256i lo = _mm256_and_si256(c, nib);
+
+        __m256i bad = _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, lo), _mm256_shuffle_epi8(lut_hi, hi));
+        if (!_mm256_testz_si256(bad, bad)) break;
+
+        __m256i off = _mm256_shuffle_epi8(lut_off, hi);
+        off = _mm256_add_epi8(off, _mm256_and_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('-')),
+                                                    _mm256_set1_epi8(FIX_MINUS)));
+        off = _mm256_add_epi8(off, _mm256_and_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('/')),
+                                                    _mm256_set1_epi8(FIX_SLASH)));
+        off = _mm256_add_epi8(off, _mm256_and_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')),
+                                                    _mm256_set1_epi8(FIX_UNDER)));
+        __m256i v = _mm256_add_epi8(c, off);
+
+        v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+        v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+        v = _mm256_shuffle_epi8(v, shuf);
+        /* Close the gap between the halves' 12-byte results */
+        v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+        _mm_storeu_si128((__m128i *)out, _mm256_castsi256_si128(v));
+        _mm_storel_epi64((__m128i *)(out + 16), _mm256_extracti128_si256(v, 1));
+    }
+    return i;
+}
+
+int usr_base64_simd_compiled(void) { return 1; }
+
+#else /* !USR_X86 */
+
+/* Never selected: usr_base64_simd_compiled() reports them as unavailable. */
+size_t usr_base64_encode_ssse3(const uint8_t *in, size_t in_len, char *out, int url) {
+    (void)in; (void)in_len; (void)out; (void)url;
+    return 0;
+}
+
+size_t usr_base64_encode_avx2(const uint8_t *in, size_t in_len, char *out, int url) {
+    (void)in; (void)in_len; (void)out; (void)url;
+    return 0;
+}
+
+size_t usr_base64_decode_ssse3(const char *in, size_t in_len, uint8_t *out) {
+    (void)in; (void)in_len; (void)out;
+    return 0;
+}
+
+size_t usr_base64_decode_avx2(const char *in, size_t in_len, uint8_t *out) {
+    (void)in; (void)in_len; (void)out;
+    return 0;
+}
+
+int usr_base64_simd_compiled(void) { return 0; }
+
+#endif
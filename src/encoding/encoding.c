@@ -1,4 +1,6 @@
 #include "usr/encoding.h"
+#include "base64_impl.h"
+#include "cpu_features.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
@@ -6,6 +8,11 @@
 
 /* ============================================================
    BASE64
+
+   Bulk input goes through the SSSE3/AVX2 kernels in base64_simd.c
+   when the CPU has them; the scalar loops below finish the tail and
+   handle everything the decode kernels decline (whitespace, padding,
+   invalid characters), so results and errors match either way.
    ============================================================ */
 
 static const char B64_STD[] =
@@ -40,9 +47,27 @@ size_t usr_base64_dec_size(size_t enc_len) {
     return ((enc_len + 3) / 4) * 3 + 1;
 }
 
-static size_t base64_encode_impl(const uint8_t *in, size_t in_len,
-                                  char *out, const char *alpha, int pad) {
-    size_t i = 0, o = 0;
+/* Returns input bytes consumed; 4 characters written per 3 */
+static size_t base64_encode_simd(const uint8_t *in, size_t in_len, char *out, int url) {
+    if (!usr_base64_simd_compiled() || !usr_cpu_has(USR_CPU_SSSE3)) return 0;
+    size_t i = 0;
+    if (usr_cpu_has(USR_CPU_AVX2)) i = usr_base64_encode_avx2(in, in_len, out, url);
+    return i + usr_base64_encode_ssse3(in + i, in_len - i, out + i / 3 * 4, url);
+}
+
+/* Returns characters consumed (whole quartets); 3 bytes written per 4 */
+static size_t base64_decode_simd(const char *in, size_t in_len, uint8_t *out) {
+    if (!usr_base64_simd_compiled() || !usr_cpu_has(USR_CPU_SSSE3)) return 0;
+    size_t i = 0;
+    if (usr_cpu_has(USR_CPU_AVX2)) i = usr_base64_decode_avx2(in, in_len, out);
+    return i + usr_base64_decode_ssse3(in + i, in_len - i, out + i / 4 * 3);
+}
+
+/* Whole 3-byte groups only; returns characters written (no NUL) */
+static size_t base64_encode_groups(const uint8_t *in, size_t in_len,
+                                   char *out, const char *alpha) {
+    size_t i = base64_encode_simd(in, in_len, out, alpha == B64_URL);
+    size_t o = i / 3 * 4;
     while (i + 3 <= in_len) {
         uint32_t v = ((uint32_t)in[i] << 16)
                    | ((uint32_t)in[i+1] << 8)
@@ -53,6 +78,30 @@ static size_t base64_encode_impl(const uint8_t *in, size_t in_len,
         out[o++] = alpha[(v      ) & 0x3F];
         i += 3;
     }
+    return o;
+}
+
+/* Leading run of whole quartets with no whitespace or padding;
+   returns characters consumed, 3 bytes written per 4 */
+static size_t base64_decode_quads(const char *in, size_t in_len, uint8_t *out) {
+    size_t i = in_len >= 16 ? base64_decode_simd(in, in_len, out) : 0;
+    size_t o = i / 4 * 3;
+    while (i + 4 <= in_len) {
+        int a = B64_DEC[(uint8_t)in[i]],   b = B64_DEC[(uint8_t)in[i+1]];
+        int c = B64_DEC[(uint8_t)in[i+2]], d = B64_DEC[(uint8_t)in[i+3]];
+        if ((a | b | c | d) < 0) break;
+        out[o++] = (uint8_t)((a << 2) | (b >> 4));
+        out[o++] = (uint8_t)((b << 4) | (c >> 2));
+        out[o++] = (uint8_t)((c << 6) | d);
+        i += 4;
+    }
+    return i;
+}
+
+static size_t base64_encode_impl(const uint8_t *in, size_t in_len,
+                                  char *out, const char *alpha, int pad) {
+    size_t o = base64_encode_groups(in, in_len, out, alpha);
+    size_t i = o / 4 * 3;
     size_t rem = in_len - i;
     if (rem == 1) {
         out[o++] = alpha[(in[i] >> 2) & 0x3F];
@@ -73,6 +122,11 @@ static size_t base64_decode_impl(const char *in, size_t in_len, uint8_t *out) {
     size_t o = 0;
     size_t i = 0;
     while (i < in_len) {
+        size_t n = base64_decode_quads(in + i, in_len - i, out + o);
+        i += n;
+        o += n / 4 * 3;
+        if (i == in_len) break;
+
         /* Skip whitespace */
         if (in[i] == '\r' || in[i] == '\n' || in[i] == ' ') { i++; continue; }
 
@@ -151,6 +205,122 @@ uint8_t *usr_base64url_decode_alloc(const char *in, size_t in_len, size_t *out_l
     return out;
 }
 
+/* ============================================================
+   Streaming Base64
+
+   The encoder carries up to 2 bytes of an incomplete group between
+   calls. The decoder carries up to 3 characters of an incomplete
+   quartet and applies the one-shot decoder's rules one character
+   at a time: whitespace is skipped between quartets, padding ends
+   the input, and anything else is an error. The result for any
+   split of the input is the same as for usr_base64_decode() on the
+   whole.
+   ============================================================ */
+
+void usr_base64_encode_init(usr_base64_enc_ctx *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void usr_base64url_encode_init(usr_base64_enc_ctx *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->url = 1;
+}
+
+size_t usr_base64_encode_update(usr_base64_enc_ctx *ctx, const uint8_t *in, size_t in_len,
+                                char *out) {
+    if (!ctx || !in || !out || in_len == 0) return 0;
+    const char *alpha = ctx->url ? B64_URL : B64_STD;
+    size_t o = 0;
+
+    if (ctx->npending > 0) {
+        while (ctx->npending < 3 && in_len > 0) {
+            ctx->pending[ctx->npending++] = *in++;
+            in_len--;
+        }
+        if (ctx->npending < 3) return 0;
+        o = base64_encode_groups(ctx->pending, 3, out, alpha);
+        ctx->npending = 0;
+    }
+
+    size_t n = in_len / 3 * 3;
+    o += base64_encode_groups(in, n, out + o, alpha);
+    memcpy(ctx->pending, in + n, in_len - n);
+    ctx->npending = (uint8_t)(in_len - n);
+    return o;
+}
+
+size_t usr_base64_encode_final(usr_base64_enc_ctx *ctx, char *out) {
+    if (!ctx || !out) return 0;
+    size_t o = base64_encode_impl(ctx->pending, ctx->npending, out,
+                                  ctx->url ? B64_URL : B64_STD, !ctx->url);
+    memset(ctx, 0, sizeof(*ctx));
+    return o;
+}
+
+void usr_base64_decode_init(usr_base64_dec_ctx *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+/* Emit the bytes of quad[0..n), n = 2..4 */
+static size_t base64_quad_bytes(const uint8_t *q, size_t n, uint8_t *out) {
+    out[0] = (uint8_t)((q[0] << 2) | (q[1] >> 4));
+    if (n > 2) out[1] = (uint8_t)((q[1] << 4) | (q[2] >> 2));
+    if (n > 3) out[2] = (uint8_t)((q[2] << 6) | q[3]);
+    return n - 1;
+}
+
+size_t usr_base64_decode_update(usr_base64_dec_ctx *ctx, const char *in, size_t in_len,
+                                uint8_t *out) {
+    if (!ctx || ctx->error) return (size_t)-1;
+    if (!in || !out || in_len == 0 || ctx->done) return 0;
+
+    size_t i = 0, o = 0;
+    while (i < in_len) {
+        if (ctx->nquad == 0) {
+            size_t n = base64_decode_quads(in + i, in_len - i, out + o);
+            i += n;
+            o += n / 4 * 3;
+            if (i == in_len) break;
+        }
+
+        uint8_t ch = (uint8_t)in[i++];
+        if (ctx->nquad == 0 && (ch == '\r' || ch == '\n' || ch == ' ')) continue;
+
+        int v = B64_DEC[ch];
+        if (v == -2 && ctx->nquad >= 2) {
+            /* Padding: the input ends with this quartet */
+            o += base64_quad_bytes(ctx->quad, ctx->nquad, out + o);
+            ctx->nquad = 0;
+            ctx->done  = 1;
+            break;
+        }
+        if (v < 0) {
+            ctx->error = 1;
+            return (size_t)-1;
+        }
+        ctx->quad[ctx->nquad++] = (uint8_t)v;
+        if (ctx->nquad == 4) {
+            o += base64_quad_bytes(ctx->quad, 4, out + o);
+            ctx->nquad = 0;
+        }
+    }
+    return o;
+}
+
+size_t usr_base64_decode_final(usr_base64_dec_ctx *ctx, uint8_t *out) {
+    if (!ctx || !out) return (size_t)-1;
+    size_t o = 0;
+    if (ctx->error || ctx->nquad == 1) {
+        o = (size_t)-1;
+    } else if (ctx->nquad > 1) {
+        /* Unpadded final quartet */
+        o = base64_quad_bytes(ctx->quad, ctx->nquad, out);
+    }
+    if (o != (size_t)-1) out[o] = '\0';
+    memset(ctx, 0, sizeof(*ctx));
+    return o;
+}
+
 /* ============================================================
    HEX ENCODING
    ============================================================ */
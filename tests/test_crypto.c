@@ -4,6 +4,12 @@
 #include <stdint.h>
 #include "usr/crypto.h"
 #include "usr/encoding.h"
+#include "usr/rand.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#  include <sys/wait.h>
+#endif
 
 static int pass = 0, fail = 0;
 
@@ -22,6 +28,52 @@ static void check_hex(const char *test_name,
     }
 }
 
+static void test_sha1(void) {
+    printf("\n── SHA-1 ──\n");
+    uint8_t out[20];
+
+    usr_sha1((uint8_t*)"abc", 3, out);
+    check_hex("SHA1(abc)", out, 20, "a9993e364706816aba3e25717850c26c9cd0d89d");
+
+    usr_sha1((uint8_t*)"", 0, out);
+    check_hex("SHA1(\"\")", out, 20, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+
+    const char *m448 = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    usr_sha1((uint8_t*)m448, strlen(m448), out);
+    check_hex("SHA1(448-bit msg)", out, 20, "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+
+    usr_sha1_ctx ctx;
+    usr_sha1_init(&ctx);
+    usr_sha1_update(&ctx, (uint8_t*)"ab", 2);
+    usr_sha1_update(&ctx, (uint8_t*)"c", 1);
+    usr_sha1_final(&ctx, out);
+    check_hex("SHA1 streaming (abc)", out, 20, "a9993e364706816aba3e25717850c26c9cd0d89d");
+
+    {
+        uint8_t *big = (uint8_t*)malloc(1000000);
+        memset(big, 'a', 1000000);
+        usr_sha1(big, 1000000, out);
+        free(big);
+        check_hex("SHA1(1M 'a')", out, 20, "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+    }
+
+    /* SHA-NI and portable paths agree around the padding boundaries */
+    {
+        uint8_t msg[300], fast[20], slow[20];
+        int ok = 1;
+        for (int i = 0; i < 300; i++) msg[i] = (uint8_t)(i * 11 + 3);
+        for (size_t len = 0; len <= sizeof(msg); len++) {
+            usr_sha1(msg, len, fast);
+            usr_cpu_disable(USR_CPU_SHA);
+            usr_sha1(msg, len, slow);
+            usr_cpu_disable(0);
+            ok = ok && memcmp(fast, slow, 20) == 0;
+        }
+        if (ok) { printf("  ✅ SHA-1 SHA-NI path matches portable path\n"); pass++; }
+        else    { printf("  ❌ SHA-1 SHA-NI/portable mismatch\n"); fail++; }
+    }
+}
+
 static void test_sha256(void) {
     printf("\n── SHA-256 ──\n");
     uint8_t out[32];
@@ -65,6 +117,74 @@ static void test_sha256(void) {
             out, 32,
             "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
     }
+
+    /* Accelerated kernels must agree with the portable code at every
+       length around the block and padding boundaries */
+    {
+        static const uint32_t paths[] = {
+            0, USR_CPU_SHA, USR_CPU_SHA | USR_CPU_AVX2
+        };
+        const uint32_t portable = USR_CPU_SHA | USR_CPU_AVX2 | USR_CPU_SSSE3;
+        uint8_t msg[300], fast[32], slow[32];
+        int ok = 1;
+        for (int i = 0; i < 300; i++) msg[i] = (uint8_t)(i * 7 + 1);
+        for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+            for (size_t len = 0; len <= sizeof(msg); len++) {
+                usr_cpu_disable(paths[p]);
+                usr_sha256(msg, len, fast);
+                usr_cpu_disable(portable);
+                usr_sha256(msg, len, slow);
+                ok = ok && memcmp(fast, slow, 32) == 0;
+            }
+        }
+        usr_cpu_disable(0);
+        if (ok) { printf("  ✅ SHA-256 SHA-NI / AVX2 / SSSE3 paths match portable path\n"); pass++; }
+        else    { printf("  ❌ SHA-256 accelerated/portable mismatch\n"); fail++; }
+    }
+}
+
+static void test_sha256_many(void) {
+    printf("\n── SHA-256 multi-buffer ──\n");
+
+    /* Mixed lengths around the padding boundaries, plus some long ones */
+    enum { N = 77 };
+    usr_sha256_job jobs[N];
+    uint8_t *digests = malloc(N * 32);
+    uint8_t *msg = malloc(5000);
+    for (int i = 0; i < 5000; i++) msg[i] = (uint8_t)(i * 13 + 7);
+    for (int i = 0; i < N; i++) {
+        jobs[i].len  = (i % 11 == 0) ? (size_t)(1000 + 37 * i) : (size_t)(i * 3 % 130);
+        jobs[i].data = msg + i;
+        jobs[i].out  = digests + 32 * i;
+    }
+
+    static const uint32_t paths[] = {
+        0, USR_CPU_AVX512F | USR_CPU_SHA, USR_CPU_AVX512F | USR_CPU_AVX2
+    };
+    static const char *names[] = { "AVX-512", "AVX2", "fallback" };
+    for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+        usr_cpu_disable(paths[p]);
+        memset(digests, 0, N * 32);
+        int ok = usr_sha256_many(jobs, N) == 0;
+        for (int i = 0; i < N; i++) {
+            uint8_t ref[32];
+            usr_sha256(jobs[i].data, jobs[i].len, ref);
+            ok = ok && memcmp(ref, jobs[i].out, 32) == 0;
+        }
+        if (ok) { printf("  ✅ usr_sha256_many matches usr_sha256 (%s)\n", names[p]); pass++; }
+        else    { printf("  ❌ usr_sha256_many mismatch (%s)\n", names[p]); fail++; }
+    }
+    usr_cpu_disable(0);
+
+    jobs[5].out = NULL;
+    if (usr_sha256_many(jobs, N) == -1) {
+        printf("  ✅ usr_sha256_many rejects a job without output\n"); pass++;
+    } else {
+        printf("  ❌ usr_sha256_many accepted a NULL output\n"); fail++;
+    }
+
+    free(digests);
+    free(msg);
 }
 
 static void test_sha512(void) {
@@ -80,6 +200,116 @@ static void test_sha512(void) {
     check_hex("SHA512(\"abc\")",
         out, 64,
         "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+
+    /* 896-bit message (two blocks after padding) */
+    const char *msg2 = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                       "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+    usr_sha512((uint8_t*)msg2, strlen(msg2), out);
+    check_hex("SHA512(896-bit msg)",
+        out, 64,
+        "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909");
+
+    {
+        uint8_t *big = (uint8_t*)malloc(1000000);
+        memset(big, 'a', 1000000);
+        usr_sha512(big, 1000000, out);
+        free(big);
+        check_hex("SHA512(1M 'a')",
+            out, 64,
+            "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b");
+    }
+
+    {
+        static const uint32_t paths[] = { 0, USR_CPU_AVX2 };
+        const uint32_t portable = USR_CPU_AVX2 | USR_CPU_SSSE3;
+        uint8_t msg[600], fast[64], slow[64];
+        int ok = 1;
+        for (int i = 0; i < 600; i++) msg[i] = (uint8_t)(i * 11 + 5);
+        for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+            for (size_t len = 0; len <= sizeof(msg); len++) {
+                usr_cpu_disable(paths[p]);
+                usr_sha512(msg, len, fast);
+                usr_cpu_disable(portable);
+                usr_sha512(msg, len, slow);
+                ok = ok && memcmp(fast, slow, 64) == 0;
+            }
+        }
+        usr_cpu_disable(0);
+        if (ok) { printf("  ✅ SHA-512 AVX2 / SSSE3 paths match portable path\n"); pass++; }
+        else    { printf("  ❌ SHA-512 accelerated/portable mismatch\n"); fail++; }
+    }
+}
+
+static void test_sha_midstate(void) {
+    printf("\n── SHA-256/512 midstates ──\n");
+    uint8_t msg[400];
+    for (int i = 0; i < 400; i++) msg[i] = (uint8_t)(i * 29 + 5);
+
+    /* Hash a prefix, then continue from a clone and from an
+       export/import round trip; both must match the one-shot hash */
+    int ok256 = 1, ok512 = 1;
+    for (size_t split = 0; split <= sizeof(msg); split += 19) {
+        uint8_t ref[64], got[64];
+        uint8_t blob256[USR_SHA256_EXPORT_SIZE], blob512[USR_SHA512_EXPORT_SIZE];
+
+        usr_sha256_ctx p256, c256, i256;
+        usr_sha256_init(&p256);
+        usr_sha256_update(&p256, msg, split);
+        usr_sha256_clone(&c256, &p256);
+        ok256 = ok256 && usr_sha256_export(&p256, blob256) == 0
+                      && usr_sha256_import(&i256, blob256) == 0;
+        usr_sha256(msg, sizeof(msg), ref);
+        usr_sha256_update(&c256, msg + split, sizeof(msg) - split);
+        usr_sha256_final(&c256, got);
+        ok256 = ok256 && memcmp(ref, got, 32) == 0;
+        usr_sha256_update(&i256, msg + split, sizeof(msg) - split);
+        usr_sha256_final(&i256, got);
+        ok256 = ok256 && memcmp(ref, got, 32) == 0;
+
+        usr_sha512_ctx p512, c512, i512;
+        usr_sha512_init(&p512);
+        usr_sha512_update(&p512, msg, split);
+        usr_sha512_clone(&c512, &p512);
+        ok512 = ok512 && usr_sha512_export(&p512, blob512) == 0
+                      && usr_sha512_import(&i512, blob512) == 0;
+        usr_sha512(msg, sizeof(msg), ref);
+        usr_sha512_update(&c512, msg + split, sizeof(msg) - split);
+        usr_sha512_final(&c512, got);
+        ok512 = ok512 && memcmp(ref, got, 64) == 0;
+        usr_sha512_update(&i512, msg + split, sizeof(msg) - split);
+        usr_sha512_final(&i512, got);
+        ok512 = ok512 && memcmp(ref, got, 64) == 0;
+    }
+    if (ok256) { printf("  ✅ SHA-256 clone / export / import resume correctly\n"); pass++; }
+    else       { printf("  ❌ SHA-256 midstate mismatch\n"); fail++; }
+    if (ok512) { printf("  ✅ SHA-512 clone / export / import resume correctly\n"); pass++; }
+    else       { printf("  ❌ SHA-512 midstate mismatch\n"); fail++; }
+
+    /* The format is fixed: "abc" buffered in a fresh context */
+    uint8_t blob[USR_SHA512_EXPORT_SIZE];
+    usr_sha256_ctx ctx;
+    usr_sha256_init(&ctx);
+    usr_sha256_update(&ctx, (uint8_t*)"abc", 3);
+    usr_sha256_export(&ctx, blob);
+    check_hex("SHA-256 export header/state/length",
+              blob, 48,
+              "75732001"
+              "6a09e667bb67ae853c6ef372a54ff53a510e527f9b05688c1f83d9ab5be0cd19"
+              "0000000000000018" "03616263");
+
+    /* Malformed input is rejected */
+    usr_sha256_ctx bad;
+    int rejected = 1;
+    blob[3] = 2;                              /* unknown version */
+    rejected = rejected && usr_sha256_import(&bad, blob) == -1;
+    blob[3] = 1; blob[44] = 4;                /* buflen disagrees with length */
+    rejected = rejected && usr_sha256_import(&bad, blob) == -1;
+    blob[44] = 3; blob[2] = 0x40;             /* SHA-512 tag on a SHA-256 blob */
+    rejected = rejected && usr_sha256_import(&bad, blob) == -1;
+    blob[2] = 0x20;
+    rejected = rejected && usr_sha256_import(&bad, blob) == 0;
+    if (rejected) { printf("  ✅ midstate import rejects malformed blobs\n"); pass++; }
+    else          { printf("  ❌ midstate import accepted a malformed blob\n"); fail++; }
 }
 
 static void test_hmac(void) {
@@ -94,6 +324,94 @@ static void test_hmac(void) {
     check_hex("HMAC-SHA256 RFC4231 #1",
         out, 32,
         "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+
+    /* RFC 4231 test vector 2 */
+    const char *data2 = "what do ya want for nothing?";
+    usr_hmac_sha256((uint8_t*)"Jefe", 4, (uint8_t*)data2, strlen(data2), out);
+    check_hex("HMAC-SHA256 RFC4231 #2",
+        out, 32,
+        "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+    /* RFC 4231 test vector 6: key longer than a block */
+    uint8_t key6[131];
+    memset(key6, 0xaa, sizeof(key6));
+    const char *data6 = "Test Using Larger Than Block-Size Key - Hash Key First";
+    usr_hmac_sha256(key6, sizeof(key6), (uint8_t*)data6, strlen(data6), out);
+    check_hex("HMAC-SHA256 RFC4231 #6",
+        out, 32,
+        "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+
+    /* Prepared key: one-shot and streaming MACs match usr_hmac_sha256 */
+    usr_hmac_sha256_key hk;
+    usr_hmac_sha256_key_init(&hk, key6, sizeof(key6));
+    uint8_t msg[200], ref[32];
+    int ok = 1;
+    for (int i = 0; i < 200; i++) msg[i] = (uint8_t)(i ^ 0x3c);
+    for (size_t len = 0; len <= sizeof(msg); len += 13) {
+        usr_hmac_sha256(key6, sizeof(key6), msg, len, ref);
+        usr_hmac_sha256_keyed(&hk, msg, len, out);
+        ok = ok && memcmp(ref, out, 32) == 0;
+
+        usr_hmac_sha256_ctx ctx;
+        usr_hmac_sha256_start(&ctx, &hk);
+        usr_hmac_sha256_update(&ctx, msg, len / 2);
+        usr_hmac_sha256_update(&ctx, msg + len / 2, len - len / 2);
+        usr_hmac_sha256_final(&ctx, out);
+        ok = ok && memcmp(ref, out, 32) == 0;
+    }
+    usr_hmac_sha256_key_wipe(&hk);
+    if (ok) { printf("  ✅ HMAC-SHA256 prepared key matches one-shot\n"); pass++; }
+    else    { printf("  ❌ HMAC-SHA256 prepared key mismatch\n"); fail++; }
+}
+
+static void test_hmac_sha512(void) {
+    printf("\n── HMAC-SHA512 ──\n");
+    uint8_t out[64];
+
+    /* RFC 4231 test vectors 1, 2 and 6 */
+    uint8_t key1[20];
+    memset(key1, 0x0b, 20);
+    const char *data1 = "Hi There";
+    usr_hmac_sha512(key1, 20, (uint8_t*)data1, strlen(data1), out);
+    check_hex("HMAC-SHA512 RFC4231 #1", out, 64,
+        "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cde"
+        "daa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854");
+
+    const char *data2 = "what do ya want for nothing?";
+    usr_hmac_sha512((uint8_t*)"Jefe", 4, (uint8_t*)data2, strlen(data2), out);
+    check_hex("HMAC-SHA512 RFC4231 #2", out, 64,
+        "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea250554"
+        "9758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737");
+
+    uint8_t key6[131];
+    memset(key6, 0xaa, sizeof(key6));
+    const char *data6 = "Test Using Larger Than Block-Size Key - Hash Key First";
+    usr_hmac_sha512(key6, sizeof(key6), (uint8_t*)data6, strlen(data6), out);
+    check_hex("HMAC-SHA512 RFC4231 #6", out, 64,
+        "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+        "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598");
+
+    /* Prepared key: one-shot and streaming MACs match usr_hmac_sha512 */
+    usr_hmac_sha512_key hk;
+    usr_hmac_sha512_key_init(&hk, key6, sizeof(key6));
+    uint8_t msg[300], ref[64];
+    int ok = 1;
+    for (int i = 0; i < 300; i++) msg[i] = (uint8_t)(i ^ 0x5a);
+    for (size_t len = 0; len <= sizeof(msg); len += 23) {
+        usr_hmac_sha512(key6, sizeof(key6), msg, len, ref);
+        usr_hmac_sha512_keyed(&hk, msg, len, out);
+        ok = ok && memcmp(ref, out, 64) == 0;
+
+        usr_hmac_sha512_ctx ctx;
+        usr_hmac_sha512_start(&ctx, &hk);
+        usr_hmac_sha512_update(&ctx, msg, len / 3);
+        usr_hmac_sha512_update(&ctx, msg + len / 3, len - len / 3);
+        usr_hmac_sha512_final(&ctx, out);
+        ok = ok && memcmp(ref, out, 64) == 0;
+    }
+    usr_hmac_sha512_key_wipe(&hk);
+    if (ok) { printf("  ✅ HMAC-SHA512 prepared key matches one-shot\n"); pass++; }
+    else    { printf("  ❌ HMAC-SHA512 prepared key mismatch\n"); fail++; }
 }
 
 static void test_pbkdf2(void) {
@@ -113,6 +431,219 @@ static void test_pbkdf2(void) {
     } else {
         printf("  ❌ PBKDF2 c=1\n     got: %s\n     exp: %s\n", hex, expected); fail++;
     }
+
+    /* RFC 7914 §11 */
+    uint8_t dk[64];
+    usr_pbkdf2_sha256((uint8_t*)"passwd", 6, (uint8_t*)"salt", 4, 1, dk, 64);
+    check_hex("PBKDF2 RFC 7914 passwd/salt c=1", dk, 64,
+              "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+              "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783");
+    usr_pbkdf2_sha256((uint8_t*)"Password", 8, (uint8_t*)"NaCl", 4, 80000, dk, 64);
+    check_hex("PBKDF2 RFC 7914 Password/NaCl c=80000", dk, 64,
+              "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56"
+              "a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d");
+
+    /* Threaded output blocks, with a partial last block, match serial */
+    uint8_t a[150], b[150];
+    usr_crypto_set_threads(1);
+    usr_pbkdf2_sha256((uint8_t*)"pw", 2, (uint8_t*)"NaCl", 4, 4096, a, sizeof(a));
+    usr_crypto_set_threads(3);
+    usr_pbkdf2_sha256((uint8_t*)"pw", 2, (uint8_t*)"NaCl", 4, 4096, b, sizeof(b));
+    usr_crypto_set_threads(0);
+    if (memcmp(a, b, sizeof(a)) == 0) {
+        printf("  ✅ PBKDF2 threaded blocks match serial\n"); pass++;
+    } else {
+        printf("  ❌ PBKDF2 threaded blocks differ\n"); fail++;
+    }
+}
+
+static void test_pbkdf2_sha512(void) {
+    printf("\n── PBKDF2-HMAC-SHA512 ──\n");
+    uint8_t dk[64];
+
+    usr_pbkdf2_sha512((uint8_t*)"password", 8, (uint8_t*)"salt", 4, 1, dk, 64);
+    check_hex("PBKDF2-SHA512 c=1", dk, 64,
+              "867f70cf1ade02cff3752599a3a53dc4af34c7a669815ae5d513554e1c8cf252"
+              "c02d470a285a0501bad999bfe943c08f050235d7d68b1da55e63f73b60a57fce");
+
+    const char *pw = "passwordPASSWORDpassword";
+    const char *salt = "saltSALTsaltSALTsaltSALTsaltSALTsalt";
+    usr_pbkdf2_sha512((uint8_t*)pw, strlen(pw), (uint8_t*)salt, strlen(salt),
+                      4096, dk, 64);
+    check_hex("PBKDF2-SHA512 long password/salt c=4096", dk, 64,
+              "8c0511f4c6e597c6ac6315d8f0362e225f3c501495ba23b868c005174dc4ee71"
+              "115b59f9e60cd9532fa33e0f75aefe30225c583a186cd82bd4daea9724a3d3b8");
+
+    /* Telegram 2FA cost: 100000 iterations */
+    usr_pbkdf2_sha512((uint8_t*)"password", 8, (uint8_t*)"salt", 4, 100000, dk, 64);
+    check_hex("PBKDF2-SHA512 c=100000", dk, 64,
+              "f5d17022c96af46c0a1dc49a58bbe654a28e98104883e4af4de974cda2c74122"
+              "dd082f4105a93fc80692ca4eb1a784cfeda81bfaa33f5192cc9143d818bd7581");
+
+    /* Threaded output blocks, with a partial last block, match serial */
+    uint8_t a[200], b[200];
+    usr_crypto_set_threads(1);
+    usr_pbkdf2_sha512((uint8_t*)"pw", 2, (uint8_t*)"NaCl", 4, 4096, a, sizeof(a));
+    usr_crypto_set_threads(3);
+    usr_pbkdf2_sha512((uint8_t*)"pw", 2, (uint8_t*)"NaCl", 4, 4096, b, sizeof(b));
+    usr_crypto_set_threads(0);
+    if (memcmp(a, b, sizeof(a)) == 0) {
+        printf("  ✅ PBKDF2-SHA512 threaded blocks match serial\n"); pass++;
+    } else {
+        printf("  ❌ PBKDF2-SHA512 threaded blocks differ\n"); fail++;
+    }
+}
+
+static void test_pbkdf2_many(void) {
+    printf("\n── PBKDF2 batches ──\n");
+
+    /* Mixed passwords, iteration counts and output lengths, including
+       multi-block and partial-block outputs */
+    enum { N = 37 };
+    usr_pbkdf2_job jobs[N];
+    uint8_t pw[N][24], salt[N][16];
+    uint8_t *out = malloc(N * 200), *ref = malloc(200);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < 24; j++) pw[i][j] = (uint8_t)(i * 7 + j);
+        for (int j = 0; j < 16; j++) salt[i][j] = (uint8_t)(i ^ (j * 31));
+        jobs[i].password     = pw[i];
+        jobs[i].password_len = 1 + i % 24;
+        jobs[i].salt         = salt[i];
+        jobs[i].salt_len     = i % 17;
+        jobs[i].iterations   = 1 + (uint32_t)(i * 97 % 700);
+        jobs[i].out          = out + 200 * i;
+        jobs[i].out_len      = (i % 9 == 0) ? 200 : 8 + (size_t)(i * 5 % 57);
+    }
+
+    static const uint32_t paths[] = {
+        0, USR_CPU_AVX512F, USR_CPU_AVX512F | USR_CPU_AVX2
+    };
+    static const char *names[] = { "AVX-512", "AVX2", "fallback" };
+    for (int hash = 0; hash < 2; hash++) {
+        int (*many)(const usr_pbkdf2_job *, size_t) =
+            hash ? usr_pbkdf2_sha512_many : usr_pbkdf2_sha256_many;
+        int (*one)(const uint8_t *, size_t, const uint8_t *, size_t,
+                   uint32_t, uint8_t *, size_t) =
+            hash ? usr_pbkdf2_sha512 : usr_pbkdf2_sha256;
+
+        for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+            usr_cpu_disable(paths[p]);
+            memset(out, 0, N * 200);
+            int ok = many(jobs, N) == 0;
+            usr_cpu_disable(0);
+            for (int i = 0; i < N; i++) {
+                one(jobs[i].password, jobs[i].password_len, jobs[i].salt,
+                    jobs[i].salt_len, jobs[i].iterations, ref, jobs[i].out_len);
+                ok = ok && memcmp(ref, jobs[i].out, jobs[i].out_len) == 0;
+            }
+            if (ok) { printf("  ✅ usr_pbkdf2_sha%d_many matches serial (%s)\n", hash ? 512 : 256, names[p]); pass++; }
+            else    { printf("  ❌ usr_pbkdf2_sha%d_many mismatch (%s)\n", hash ? 512 : 256, names[p]); fail++; }
+        }
+    }
+
+    /* Threaded slices */
+    uint8_t *out1 = malloc(N * 200);
+    memcpy(out1, out, N * 200);
+    usr_crypto_set_threads(3);
+    memset(out, 0, N * 200);
+    int ok = usr_pbkdf2_sha512_many(jobs, N) == 0 && memcmp(out, out1, N * 200) == 0;
+    usr_crypto_set_threads(0);
+    if (ok) { printf("  ✅ usr_pbkdf2_sha512_many threaded matches\n"); pass++; }
+    else    { printf("  ❌ usr_pbkdf2_sha512_many threaded mismatch\n"); fail++; }
+
+    jobs[3].iterations = 0;
+    if (usr_pbkdf2_sha256_many(jobs, N) == -1) {
+        printf("  ✅ usr_pbkdf2_sha256_many rejects zero iterations\n"); pass++;
+    } else {
+        printf("  ❌ usr_pbkdf2_sha256_many accepted zero iterations\n"); fail++;
+    }
+
+    free(out1);
+    free(out);
+    free(ref);
+}
+
+static void test_aes_block(void) {
+    printf("\n── AES-256 block ──\n");
+
+    /* FIPS 197 Appendix C.3 */
+    uint8_t key[32], pt[16], rk[240], block[16];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)i;
+    for (int i = 0; i < 16; i++) pt[i]  = (uint8_t)(i * 0x11);
+
+    static const usr_aes_impl impls[] = {
+        USR_AES_IMPL_BYTE, USR_AES_IMPL_TTABLE, USR_AES_IMPL_AESNI,
+        USR_AES_IMPL_BITSLICE
+    };
+    static const char *names[] = { "byte", "ttable", "aesni", "bitslice" };
+
+    for (size_t n = 0; n < sizeof(impls) / sizeof(impls[0]); n++) {
+        if (usr_aes_set_impl(impls[n]) != 0) {
+            printf("  ⏭️  %s not available\n", names[n]);
+            continue;
+        }
+        char label[64];
+
+        usr_aes256_key_expand(key, rk);
+        memcpy(block, pt, 16);
+        usr_aes256_encrypt_block(block, rk);
+        snprintf(label, sizeof(label), "AES-256 FIPS-197 encrypt (%s)", names[n]);
+        check_hex(label, block, 16, "8ea2b7ca516745bfeafc49904b496089");
+
+        usr_aes256_decrypt_block(block, rk);
+        snprintf(label, sizeof(label), "AES-256 FIPS-197 decrypt (%s)", names[n]);
+        check_hex(label, block, 16, "00112233445566778899aabbccddeeff");
+    }
+
+    /* Every implementation must agree with the reference on mode output */
+    uint8_t iv[32], ref[256], got[256];
+    for (int i = 0; i < 32; i++)  iv[i]  = (uint8_t)(0xA5 ^ i);
+    for (int i = 0; i < 256; i++) ref[i] = (uint8_t)(i * 7 + 3);
+    memcpy(got, ref, sizeof(got));
+
+    /* 250-byte CTR and 17-block CBC leave partial bulk batches */
+    uint8_t ctr_ref[250], cbc_ref[272], nonce[16];
+    size_t  cbc_len = sizeof(cbc_ref);
+    usr_aes_set_impl(USR_AES_IMPL_BYTE);
+    usr_aes256_ige_encrypt(ref, sizeof(ref), key, iv);
+    memcpy(ctr_ref, got, sizeof(ctr_ref));
+    memset(nonce, 0xFF, 16);    /* counter wraps inside the first batch */
+    nonce[15] = 0xFD;
+    usr_aes256_ctr_crypt(ctr_ref, sizeof(ctr_ref), key, nonce);
+    usr_aes256_cbc_encrypt(got, 256, key, iv, cbc_ref, &cbc_len);
+
+    for (size_t n = 1; n < sizeof(impls) / sizeof(impls[0]); n++) {
+        if (usr_aes_set_impl(impls[n]) != 0) continue;
+        uint8_t tmp[272];
+        memcpy(tmp, got, 256);
+        usr_aes256_ige_encrypt(tmp, 256, key, iv);
+        int same = memcmp(ref, tmp, sizeof(ref)) == 0;
+        usr_aes256_ige_decrypt(tmp, 256, key, iv);
+        same = same && memcmp(tmp, got, sizeof(got)) == 0;
+        if (same) {
+            printf("  ✅ %s IGE matches reference\n", names[n]); pass++;
+        } else {
+            printf("  ❌ %s IGE differs from reference\n", names[n]); fail++;
+        }
+
+        memcpy(tmp, got, sizeof(ctr_ref));
+        memset(nonce, 0xFF, 16);
+        nonce[15] = 0xFD;
+        usr_aes256_ctr_crypt(tmp, sizeof(ctr_ref), key, nonce);
+        same = memcmp(tmp, ctr_ref, sizeof(ctr_ref)) == 0;
+
+        /* CBC decrypt in place */
+        size_t len = cbc_len;
+        memcpy(tmp, cbc_ref, cbc_len);
+        same = same && usr_aes256_cbc_decrypt(tmp, cbc_len, key, iv, tmp, &len) == 0 &&
+               len == 256 && memcmp(tmp, got, 256) == 0;
+        if (same) {
+            printf("  ✅ %s CTR / CBC decrypt match reference\n", names[n]); pass++;
+        } else {
+            printf("  ❌ %s CTR / CBC decrypt differ from reference\n", names[n]); fail++;
+        }
+    }
+    usr_aes_set_impl(USR_AES_IMPL_AUTO);
 }
 
 static void test_aes_ige(void) {
@@ -141,6 +672,108 @@ static void test_aes_ige(void) {
     else { printf("  ❌ non-block size not rejected\n"); fail++; }
 }
 
+static void test_aes_ige_stream(void) {
+    printf("\n── AES-256-IGE streaming ──\n");
+
+    static const size_t chunks[] = { 5, 16, 0, 27, 64, 1, 130, 9 };
+    uint8_t key[32], iv[32], msg[1024], ref[1024], buf[1024];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 11 + 3);
+    for (int i = 0; i < 32; i++) iv[i]  = (uint8_t)(i * 7);
+    for (int i = 0; i < 1024; i++) msg[i] = (uint8_t)(i ^ (i >> 3));
+    memcpy(ref, msg, sizeof(ref));
+    usr_aes256_ige_encrypt(ref, sizeof(ref), key, iv);
+
+    /* Encrypt out of place in socket-sized pieces */
+    usr_aes256_ige_ctx ctx;
+    size_t in_pos = 0, out_pos = 0, k = 0;
+    usr_aes256_ige_encrypt_init(&ctx, key, iv);
+    while (in_pos < sizeof(msg)) {
+        size_t n = chunks[k++ % 8];
+        if (n > sizeof(msg) - in_pos) n = sizeof(msg) - in_pos;
+        size_t w = sizeof(buf) - out_pos;
+        usr_aes256_ige_update(&ctx, msg + in_pos, n, buf + out_pos, &w);
+        in_pos += n; out_pos += w;
+    }
+    int ok = usr_aes256_ige_final(&ctx) == 0 && out_pos == sizeof(ref) &&
+             memcmp(buf, ref, sizeof(ref)) == 0;
+    if (ok) { printf("  ✅ IGE stream encrypt matches one-shot\n"); pass++; }
+    else    { printf("  ❌ IGE stream encrypt mismatch\n"); fail++; }
+
+    /* Decrypt in place as the bytes arrive */
+    in_pos = 0; out_pos = 0; k = 0;
+    usr_aes256_ige_decrypt_init(&ctx, key, iv);
+    while (in_pos < sizeof(buf)) {
+        size_t n = chunks[k++ % 8];
+        if (n > sizeof(buf) - in_pos) n = sizeof(buf) - in_pos;
+        size_t w = sizeof(buf) - out_pos;
+        usr_aes256_ige_update(&ctx, buf + in_pos, n, buf + out_pos, &w);
+        in_pos += n; out_pos += w;
+    }
+    ok = usr_aes256_ige_final(&ctx) == 0 && out_pos == sizeof(msg) &&
+         memcmp(buf, msg, sizeof(msg)) == 0;
+    if (ok) { printf("  ✅ IGE stream decrypt in place matches\n"); pass++; }
+    else    { printf("  ❌ IGE stream decrypt in place mismatch\n"); fail++; }
+
+    /* A trailing partial block is an error at final() */
+    size_t w = sizeof(buf);
+    usr_aes256_ige_decrypt_init(&ctx, key, iv);
+    usr_aes256_ige_update(&ctx, ref, 40, buf, &w);
+    ok = w == 32 && usr_aes256_ige_final(&ctx) == -1;
+    if (ok) { printf("  ✅ IGE stream rejects partial final block\n"); pass++; }
+    else    { printf("  ❌ IGE stream partial block handling\n"); fail++; }
+}
+
+static void test_aes_ige_many(void) {
+    printf("\n── AES-256-IGE multi-buffer ──\n");
+
+    enum { N = 21 };
+    static uint8_t data[N][512], ref[N][512];
+    uint8_t keys[N][32], ivs[N][32];
+    usr_aes256_ige_job jobs[N];
+
+    for (int j = 0; j < N; j++) {
+        size_t len = 16 * (size_t)(1 + (j * 7) % 32);   /* 16..512 bytes */
+        for (int i = 0; i < 32; i++) {
+            keys[j][i] = (uint8_t)(j * 37 + i);
+            ivs[j][i]  = (uint8_t)(j ^ (i * 3));
+        }
+        for (size_t i = 0; i < len; i++) data[j][i] = (uint8_t)(i * j + 5);
+        memcpy(ref[j], data[j], len);
+        usr_aes256_ige_encrypt(ref[j], len, keys[j], ivs[j]);
+        jobs[j].data = data[j];
+        jobs[j].len  = len;
+        jobs[j].key  = keys[j];
+        jobs[j].iv   = ivs[j];
+    }
+
+    int ok = usr_aes256_ige_encrypt_many(jobs, N) == 0;
+    for (int j = 0; j < N; j++) ok = ok && memcmp(data[j], ref[j], jobs[j].len) == 0;
+    if (ok) { printf("  ✅ IGE encrypt_many matches per-message IGE\n"); pass++; }
+    else    { printf("  ❌ IGE encrypt_many mismatch\n"); fail++; }
+
+    ok = usr_aes256_ige_decrypt_many(jobs, N) == 0;
+    for (int j = 0; j < N; j++) {
+        for (size_t i = 0; i < jobs[j].len; i++) ok = ok && data[j][i] == (uint8_t)(i * j + 5);
+    }
+    if (ok) { printf("  ✅ IGE decrypt_many round-trip\n"); pass++; }
+    else    { printf("  ❌ IGE decrypt_many round-trip\n"); fail++; }
+
+    /* Backends without a lane kernel fall back to one message at a time */
+    usr_aes_set_impl(USR_AES_IMPL_TTABLE);
+    ok = usr_aes256_ige_encrypt_many(jobs, N) == 0;
+    for (int j = 0; j < N; j++) ok = ok && memcmp(data[j], ref[j], jobs[j].len) == 0;
+    ok = ok && usr_aes256_ige_decrypt_many(jobs, N) == 0;
+    usr_aes_set_impl(USR_AES_IMPL_AUTO);
+    if (ok) { printf("  ✅ IGE encrypt_many serial fallback\n"); pass++; }
+    else    { printf("  ❌ IGE encrypt_many serial fallback\n"); fail++; }
+
+    /* One bad job rejects the whole batch before any data changes */
+    jobs[N - 1].len = 20;
+    ok = usr_aes256_ige_encrypt_many(jobs, N) == -1 && data[0][0] == 5;
+    if (ok) { printf("  ✅ IGE encrypt_many rejects unaligned job\n"); pass++; }
+    else    { printf("  ❌ IGE encrypt_many accepted unaligned job\n"); fail++; }
+}
+
 static void test_aes_cbc(void) {
     printf("\n── AES-256-CBC ──\n");
 
@@ -167,6 +800,119 @@ static void test_aes_cbc(void) {
     }
 }
 
+static void test_aes_cbc_parallel(void) {
+    printf("\n── AES-256-CBC large / threaded decrypt ──\n");
+
+    uint8_t key[32], iv[16];
+    memset(key, 0x44, 32);
+    memset(iv,  0x55, 16);
+
+    /* Large enough for the threaded path, uneven split across ranges */
+    size_t   plain_len = (3u << 20) + 37;
+    size_t   enc_len = plain_len + 16, dec_len;
+    uint8_t *plain = (uint8_t*)malloc(plain_len);
+    uint8_t *enc   = (uint8_t*)malloc(enc_len);
+    uint8_t *dec   = (uint8_t*)malloc(enc_len);
+    for (size_t i = 0; i < plain_len; i++) plain[i] = (uint8_t)(i * 131 + (i >> 11));
+
+    usr_aes256_cbc_encrypt(plain, plain_len, key, iv, enc, &enc_len);
+
+    usr_crypto_set_threads(1);
+    dec_len = enc_len;
+    int ok = usr_aes256_cbc_decrypt(enc, enc_len, key, iv, dec, &dec_len) == 0 &&
+             dec_len == plain_len && memcmp(dec, plain, plain_len) == 0;
+    if (ok) { printf("  ✅ CBC decrypt 3 MiB single-threaded\n"); pass++; }
+    else    { printf("  ❌ CBC decrypt 3 MiB single-threaded\n"); fail++; }
+
+    usr_crypto_set_threads(5);
+    dec_len = enc_len;
+    ok = usr_aes256_cbc_decrypt(enc, enc_len, key, iv, dec, &dec_len) == 0 &&
+         dec_len == plain_len && memcmp(dec, plain, plain_len) == 0;
+    if (ok) { printf("  ✅ CBC decrypt 3 MiB with 5 threads\n"); pass++; }
+    else    { printf("  ❌ CBC decrypt 3 MiB with 5 threads\n"); fail++; }
+
+    /* In place: range boundaries must use the original ciphertext */
+    memcpy(dec, enc, enc_len);
+    dec_len = enc_len;
+    ok = usr_aes256_cbc_decrypt(dec, enc_len, key, iv, dec, &dec_len) == 0 &&
+         dec_len == plain_len && memcmp(dec, plain, plain_len) == 0;
+    if (ok) { printf("  ✅ CBC decrypt 3 MiB in place with 5 threads\n"); pass++; }
+    else    { printf("  ❌ CBC decrypt 3 MiB in place with 5 threads\n"); fail++; }
+
+    /* Corrupt padding is still reported */
+    enc[enc_len - 1] ^= 0x01;
+    dec_len = enc_len;
+    if (usr_aes256_cbc_decrypt(enc, enc_len, key, iv, dec, &dec_len) == -1) {
+        printf("  ✅ CBC threaded decrypt rejects bad padding\n"); pass++;
+    } else {
+        printf("  ❌ CBC threaded decrypt accepted bad padding\n"); fail++;
+    }
+    usr_crypto_set_threads(0);
+
+    free(plain); free(enc); free(dec);
+}
+
+static void test_aes_cbc_stream(void) {
+    printf("\n── AES-256-CBC streaming ──\n");
+
+    static const size_t chunks[] = { 1, 7, 16, 33, 0, 100, 15, 250, 3 };
+    uint8_t key[32], iv[16], msg[1000], ref[1024], enc[1024], buf[1024];
+    size_t  ref_len = sizeof(ref);
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 5 + 9);
+    for (int i = 0; i < 16; i++) iv[i]  = (uint8_t)(0xC3 ^ i);
+    for (int i = 0; i < 1000; i++) msg[i] = (uint8_t)(i * 29 + 1);
+    usr_aes256_cbc_encrypt(msg, sizeof(msg), key, iv, ref, &ref_len);
+
+    /* Encrypt in odd-sized chunks, out of place */
+    usr_aes256_cbc_ctx ctx;
+    size_t in_pos = 0, out_pos = 0, k = 0;
+    usr_aes256_cbc_encrypt_init(&ctx, key, iv);
+    while (in_pos < sizeof(msg)) {
+        size_t n = chunks[k++ % 9];
+        if (n > sizeof(msg) - in_pos) n = sizeof(msg) - in_pos;
+        size_t w = sizeof(enc) - out_pos;
+        usr_aes256_cbc_encrypt_update(&ctx, msg + in_pos, n, enc + out_pos, &w);
+        in_pos += n; out_pos += w;
+    }
+    size_t w = sizeof(enc) - out_pos;
+    int ok = usr_aes256_cbc_encrypt_final(&ctx, enc + out_pos, &w) == 0;
+    out_pos += w;
+    ok = ok && out_pos == ref_len && memcmp(enc, ref, ref_len) == 0;
+    if (ok) { printf("  ✅ CBC stream encrypt matches one-shot\n"); pass++; }
+    else    { printf("  ❌ CBC stream encrypt mismatch\n"); fail++; }
+
+    /* Decrypt in place: output trails input by the bytes held back */
+    uint8_t plain[64];
+    memcpy(buf, ref, ref_len);
+    in_pos = 0; out_pos = 0; k = 0;
+    usr_aes256_cbc_decrypt_init(&ctx, key, iv);
+    while (in_pos < ref_len) {
+        size_t n = chunks[k++ % 9];
+        if (n > ref_len - in_pos) n = ref_len - in_pos;
+        w = sizeof(buf) - out_pos;
+        usr_aes256_cbc_decrypt_update(&ctx, buf + in_pos, n, buf + out_pos, &w);
+        in_pos += n; out_pos += w;
+    }
+    w = 16;
+    ok = usr_aes256_cbc_decrypt_final(&ctx, buf + out_pos, &w) == 0;
+    out_pos += w;
+    ok = ok && out_pos == sizeof(msg) && memcmp(buf, msg, sizeof(msg)) == 0;
+    if (ok) { printf("  ✅ CBC stream decrypt in place matches\n"); pass++; }
+    else    { printf("  ❌ CBC stream decrypt in place mismatch\n"); fail++; }
+
+    /* Undersized output is reported without consuming input */
+    usr_aes256_cbc_decrypt_init(&ctx, key, iv);
+    w = 0;
+    ok = usr_aes256_cbc_decrypt_update(&ctx, ref, 64, plain, &w) == -1 && w == 48;
+    w = 48;
+    ok = ok && usr_aes256_cbc_decrypt_update(&ctx, ref, 64, plain, &w) == 0 && w == 48;
+    ok = ok && memcmp(plain, msg, 48) == 0;
+    w = 16;
+    ok = ok && usr_aes256_cbc_decrypt_final(&ctx, plain, &w) == -1;   /* truncated */
+    if (ok) { printf("  ✅ CBC stream buffer sizing and bad padding\n"); pass++; }
+    else    { printf("  ❌ CBC stream buffer sizing / padding checks\n"); fail++; }
+}
+
 static void test_aes_ctr(void) {
     printf("\n── AES-256-CTR ──\n");
 
@@ -193,6 +939,189 @@ static void test_aes_ctr(void) {
     } else {
         printf("  ❌ AES-256-CTR round-trip FAILED\n"); fail++;
     }
+
+    /* NIST SP 800-38A F.5.5 (CTR-AES256.Encrypt) */
+    usr_aes256_ctx ctx;
+    uint8_t nist_key[32], nist_ctr[16], block[64];
+    usr_hex_decode("603deb1015ca71be2b73aef0857d7781"
+                   "1f352c073b6108d72d9810a30914dff4", 64, nist_key);
+    usr_hex_decode("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", 32, nist_ctr);
+    usr_hex_decode("6bc1bee22e409f96e93d7e117393172a"
+                   "ae2d8a571e03ac9c9eb76fac45af8e51"
+                   "30c81c46a35ce411e5fbc1191a0a52ef"
+                   "f69f2445df4f9b17ad2b417be66c3710", 128, block);
+    usr_aes256_init(&ctx, nist_key);
+    usr_aes256_ctr_crypt_ex(block, 64, &ctx, nist_ctr, 128);
+    check_hex("AES-256-CTR SP 800-38A F.5.5", block, 64,
+              "601ec313775789a5b7a7f504bbf3d228"
+              "f443e3ca4d62b59aca84e990cacaf5c5"
+              "2b0930daa23de94ce87017ba2d84988d"
+              "dfc9c58db67aada613c2dd08457941a6");
+
+    /* 64-bit counter carries out of byte 12; 32-bit wraps in place */
+    uint8_t n64[16] = {0}, n32[16] = {0}, z64[48] = {0}, z32[48] = {0};
+    memset(n64 + 12, 0xFF, 4);
+    memset(n32 + 12, 0xFF, 4);
+    usr_aes256_ctr_crypt_ex(z64, 48, &ctx, n64, 64);
+    usr_aes256_ctr_crypt_ex(z32, 48, &ctx, n32, 32);
+    check_hex("AES-256-CTR 64-bit counter carry", z64, 48,
+              "55660ce5e9c1cf3d6bbdd2ccf4243497"
+              "9ff73b5d5d7c596928427adf292d10ff"
+              "03cca10627cfc246a502a6bd7eaf48e4");
+    if (n64[11] == 1 && n64[15] == 2 && n32[11] == 0 && n32[15] == 2 &&
+        memcmp(z32 + 16, z64 + 16, 16) != 0) {
+        printf("  ✅ AES-256-CTR counter widths update nonce correctly\n"); pass++;
+    } else {
+        printf("  ❌ AES-256-CTR counter width handling wrong\n"); fail++;
+    }
+
+    if (usr_aes256_ctr_crypt_ex(z64, 16, &ctx, n64, 48) == -1) {
+        printf("  ✅ AES-256-CTR rejects unsupported counter width\n"); pass++;
+    } else {
+        printf("  ❌ AES-256-CTR accepted 48-bit counter\n"); fail++;
+    }
+    usr_aes256_wipe(&ctx);
+}
+
+static void test_aes_gcm(void) {
+    printf("\n── AES-256-GCM ──\n");
+
+    /* GCM spec test cases 13-16 (256-bit key) */
+    uint8_t key[32] = {0}, iv[12] = {0}, tag[16], blk[16] = {0};
+    usr_aes256_gcm_encrypt(key, iv, 12, NULL, 0, NULL, 0, NULL, tag);
+    check_hex("AES-256-GCM test case 13 (empty)", tag, 16,
+              "530f8afbc74536b9a963b4f1c4cb738b");
+
+    usr_aes256_gcm_encrypt(key, iv, 12, NULL, 0, blk, 16, blk, tag);
+    check_hex("AES-256-GCM test case 14 ciphertext", blk, 16,
+              "cea7403d4d606b6e074ec5d3baf39d18");
+    check_hex("AES-256-GCM test case 14 tag", tag, 16,
+              "d0d1c8a799996bf0265b98b5d48ab919");
+
+    uint8_t plain[64], aad[20], ct[64], pt[64];
+    usr_hex_decode("feffe9928665731c6d6a8f9467308308"
+                   "feffe9928665731c6d6a8f9467308308", 64, key);
+    usr_hex_decode("cafebabefacedbaddecaf888", 24, iv);
+    usr_hex_decode("d9313225f88406e5a55909c5aff5269a"
+                   "86a7a9531534f7da2e4c303d8a318a72"
+                   "1c3c0c95956809532fcf0e2449a6b525"
+                   "b16aedf5aa0de657ba637b391aafd255", 128, plain);
+    usr_hex_decode("feedfacedeadbeeffeedfacedeadbeefabaddad2", 40, aad);
+
+    usr_aes256_gcm_encrypt(key, iv, 12, NULL, 0, plain, 64, ct, tag);
+    check_hex("AES-256-GCM test case 15 tag", tag, 16,
+              "b094dac5d93471bdec1a502270e3cc6c");
+
+    /* Test case 16 on both GHASH paths (PCLMULQDQ when present, 4-bit tables) */
+    for (int pass_no = 0; pass_no < 2; pass_no++) {
+        usr_cpu_disable(pass_no ? USR_CPU_PCLMUL : 0);
+        const char *path = pass_no ? " (table GHASH)" : "";
+        char name[80];
+
+        usr_aes256_gcm_encrypt(key, iv, 12, aad, 20, plain, 60, ct, tag);
+        snprintf(name, sizeof(name), "AES-256-GCM test case 16 ciphertext%s", path);
+        check_hex(name, ct, 60,
+                  "522dc1f099567d07f47f37a32a84427d"
+                  "643a8cdcbfe5c0c97598a2bd2555d1aa"
+                  "8cb08e48590dbb3da7b08b1056828838"
+                  "c5f61e6393ba7a0abcc9f662");
+        snprintf(name, sizeof(name), "AES-256-GCM test case 16 tag%s", path);
+        check_hex(name, tag, 16, "76fc6ece0f4e1768cddf8853bb2d551b");
+    }
+    usr_cpu_disable(0);
+
+    int ok = usr_aes256_gcm_decrypt(key, iv, 12, aad, 20, ct, 60, pt, tag, 16) == 0 &&
+             memcmp(pt, plain, 60) == 0;
+    tag[3] ^= 1;
+    ok = ok && usr_aes256_gcm_decrypt(key, iv, 12, aad, 20, ct, 60, pt, tag, 16) == -1;
+    for (int i = 0; i < 60; i++) ok = ok && pt[i] == 0;
+    if (ok) { printf("  ✅ AES-256-GCM decrypt verifies tag, zeroes output on mismatch\n"); pass++; }
+    else    { printf("  ❌ AES-256-GCM decrypt/tag check wrong\n"); fail++; }
+
+    /* Streaming in odd pieces (in place) matches one-shot, with a
+       non-96-bit IV and enough data for the aggregated GHASH path */
+    enum { LEN = 3001 };
+    uint8_t *msg = malloc(LEN), *ref = malloc(LEN), *buf = malloc(LEN);
+    uint8_t ref_tag[16], long_iv[20];
+    for (int i = 0; i < LEN; i++) msg[i] = (uint8_t)(i * 29 + 3);
+    for (int i = 0; i < 20; i++) long_iv[i] = (uint8_t)(i + 1);
+    usr_aes256_gcm_encrypt(key, long_iv, 20, aad, 20, msg, LEN, ref, ref_tag);
+
+    static const size_t steps[] = { 1, 15, 16, 17, 100, 513, 7 };
+    usr_aes256_gcm_ctx gcm;
+    usr_aes256_gcm_init(&gcm, key, long_iv, 20);
+    usr_aes256_gcm_aad(&gcm, aad, 3);
+    usr_aes256_gcm_aad(&gcm, aad + 3, 17);
+    memcpy(buf, msg, LEN);
+    ok = 1;
+    for (size_t off = 0, s = 0; off < LEN; s++) {
+        size_t n = steps[s % 7];
+        if (n > LEN - off) n = LEN - off;
+        ok = ok && usr_aes256_gcm_encrypt_update(&gcm, buf + off, buf + off, n) == 0;
+        off += n;
+    }
+    ok = ok && usr_aes256_gcm_aad(&gcm, aad, 1) == -1;
+    usr_aes256_gcm_encrypt_final(&gcm, tag);
+    ok = ok && memcmp(buf, ref, LEN) == 0 && memcmp(tag, ref_tag, 16) == 0;
+
+    usr_aes256_gcm_init(&gcm, key, long_iv, 20);
+    usr_aes256_gcm_aad(&gcm, aad, 20);
+    for (size_t off = 0, s = 3; off < LEN; s++) {
+        size_t n = steps[s % 7];
+        if (n > LEN - off) n = LEN - off;
+        usr_aes256_gcm_decrypt_update(&gcm, buf + off, buf + off, n);
+        off += n;
+    }
+    ok = ok && usr_aes256_gcm_decrypt_final(&gcm, ref_tag, 12) == 0 &&
+         memcmp(buf, msg, LEN) == 0;
+    if (ok) { printf("  ✅ AES-256-GCM streaming matches one-shot\n"); pass++; }
+    else    { printf("  ❌ AES-256-GCM streaming mismatch\n"); fail++; }
+
+    free(msg); free(ref); free(buf);
+}
+
+static void test_aes_ctx(void) {
+    printf("\n── AES-256 key context ──\n");
+
+    uint8_t key[32], iv[32], a[96], b[96];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 13 + 1);
+    for (int i = 0; i < 32; i++) iv[i]  = (uint8_t)(i ^ 0x5A);
+    for (int i = 0; i < 96; i++) a[i]   = b[i] = (uint8_t)(i * 31);
+
+    usr_aes256_ctx ctx;
+    usr_aes256_init(&ctx, key);
+
+    /* IGE: ctx and raw-key paths produce the same ciphertext */
+    usr_aes256_ige_encrypt(a, 96, key, iv);
+    usr_aes256_ige_encrypt_ctx(b, 96, &ctx, iv);
+    int ok = memcmp(a, b, 96) == 0;
+    usr_aes256_ige_decrypt_ctx(b, 96, &ctx, iv);
+    usr_aes256_ige_decrypt(a, 96, key, iv);
+    ok = ok && memcmp(a, b, 96) == 0 && a[5] == (uint8_t)(5 * 31);
+    if (ok) { printf("  ✅ IGE ctx matches raw-key API\n"); pass++; }
+    else    { printf("  ❌ IGE ctx mismatch\n"); fail++; }
+
+    /* CBC */
+    uint8_t c1[112], c2[112], d[112];
+    size_t l1 = sizeof(c1), l2 = sizeof(c2), ld = sizeof(d);
+    usr_aes256_cbc_encrypt(a, 90, key, iv, c1, &l1);
+    usr_aes256_cbc_encrypt_ctx(a, 90, &ctx, iv, c2, &l2);
+    ok = l1 == l2 && memcmp(c1, c2, l1) == 0 &&
+         usr_aes256_cbc_decrypt_ctx(c2, l2, &ctx, iv, d, &ld) == 0 &&
+         ld == 90 && memcmp(d, a, 90) == 0;
+    if (ok) { printf("  ✅ CBC ctx matches raw-key API\n"); pass++; }
+    else    { printf("  ❌ CBC ctx mismatch\n"); fail++; }
+
+    /* CTR */
+    uint8_t n1[16] = {0}, n2[16] = {0};
+    memcpy(b, a, 96);
+    usr_aes256_ctr_crypt(a, 96, key, n1);
+    usr_aes256_ctr_crypt_ctx(b, 96, &ctx, n2);
+    ok = memcmp(a, b, 96) == 0 && memcmp(n1, n2, 16) == 0;
+    if (ok) { printf("  ✅ CTR ctx matches raw-key API\n"); pass++; }
+    else    { printf("  ❌ CTR ctx mismatch\n"); fail++; }
+
+    usr_aes256_wipe(&ctx);
 }
 
 static void test_crc32(void) {
@@ -204,19 +1133,215 @@ static void test_crc32(void) {
     } else {
         printf("  ❌ CRC32 expected 0xCBF43926, got 0x%08X\n", crc); fail++;
     }
+
+    /* PCLMUL folding and slicing-by-16 against a bitwise reference,
+       at every length to 1100 and several alignments */
+    enum { LEN = 1100 };
+    uint8_t *buf = malloc(LEN + 8);
+    for (int i = 0; i < LEN + 8; i++) buf[i] = (uint8_t)(i * 131 + (i >> 7));
+    static const uint32_t paths[] = { 0, USR_CPU_VPCLMUL, USR_CPU_PCLMUL };
+    static const char *names[] = { "VPCLMUL", "PCLMUL", "slicing-by-16" };
+    for (size_t p = 0; p < 3; p++) {
+        int ok = 1;
+        usr_cpu_disable(paths[p]);
+        for (size_t off = 0; off < 4; off++) {
+            uint32_t ref = 0xFFFFFFFFu;
+            for (size_t len = 0; len <= LEN; len++) {
+                if (len) {
+                    ref ^= buf[off + len - 1];
+                    for (int k = 0; k < 8; k++) ref = (ref >> 1) ^ (0xEDB88320u & (0u - (ref & 1)));
+                }
+                ok = ok && usr_crc32(buf + off, len) == (ref ^ 0xFFFFFFFFu);
+            }
+        }
+        /* Chained updates over uneven pieces */
+        uint32_t c = 0;
+        for (size_t pos = 0, step = 1; pos < LEN; pos += step, step = step * 3 + 1) {
+            size_t n = pos + step > LEN ? LEN - pos : step;
+            c = usr_crc32_update(c, buf + pos, n);
+        }
+        ok = ok && c == usr_crc32(buf, LEN);
+        usr_cpu_disable(0);
+        if (ok) { printf("  ✅ CRC-32 %s path matches bitwise reference\n", names[p]); pass++; }
+        else    { printf("  ❌ CRC-32 %s path mismatch\n", names[p]); fail++; }
+    }
+
+    /* Combine at every split point, including empty halves */
+    int ok = usr_crc32_combine(0x12345678u, 0, 0) == 0x12345678u;
+    uint32_t whole = usr_crc32(buf, LEN);
+    for (size_t cut = 0; cut <= LEN; cut++) {
+        ok = ok && usr_crc32_combine(usr_crc32(buf, cut), usr_crc32(buf + cut, LEN - cut),
+                                     LEN - cut) == whole;
+    }
+    if (ok) { printf("  ✅ CRC-32 combine matches the whole-buffer CRC\n"); pass++; }
+    else    { printf("  ❌ CRC-32 combine mismatch\n"); fail++; }
+    free(buf);
+
+    /* Threaded ranges over a large buffer, continuing a previous CRC */
+    enum { BIG = (21 << 20) + 77 };
+    uint8_t *big = malloc(BIG);
+    for (size_t i = 0; i < BIG; i++) big[i] = (uint8_t)(i * 2654435761u >> 24);
+    usr_crypto_set_threads(1);
+    uint32_t serial = usr_crc32_update(0xDEADBEEFu, big, BIG);
+    usr_crypto_set_threads(3);
+    uint32_t par = usr_crc32_update(0xDEADBEEFu, big, BIG);
+    ok = par == serial && usr_crc32(big, BIG) == 0x142A3F89u;
+    usr_crypto_set_threads(0);
+    if (ok) { printf("  ✅ CRC-32 threaded ranges match serial\n"); pass++; }
+    else    { printf("  ❌ CRC-32 threaded ranges differ\n"); fail++; }
+    free(big);
+}
+
+static void test_crc32c(void) {
+    printf("\n── CRC-32C ──\n");
+
+    /* Check value, and the all-zero vector from RFC 3720 B.4 */
+    uint8_t zeros[32] = {0};
+    uint32_t crc = usr_crc32c((uint8_t*)"123456789", 9);
+    if (crc == 0xE3069283u && usr_crc32c(zeros, 32) == 0x8A9136AAu) {
+        printf("  ✅ CRC32C(\"123456789\") = 0x%08X\n", crc); pass++;
+    } else {
+        printf("  ❌ CRC32C expected 0xE3069283, got 0x%08X\n", crc); fail++;
+    }
+
+    /* SSE4.2 and slicing-by-8 against a bitwise reference: every
+       length to 1100 at several alignments, then a buffer long
+       enough for the 3 x 8 KiB interleave */
+    enum { LEN = 1100, BIG = 3 * 3 * 8192 + 3 * 256 + 13 };
+    uint8_t *buf = malloc(BIG + 8);
+    for (int i = 0; i < BIG + 8; i++) buf[i] = (uint8_t)(i * 131 + (i >> 7));
+    static const uint32_t paths[] = { 0, USR_CPU_SSE42 };
+    static const char *names[] = { "SSE4.2", "slicing-by-8" };
+    for (size_t p = 0; p < 2; p++) {
+        int ok = 1;
+        usr_cpu_disable(paths[p]);
+        for (size_t off = 0; off < 4; off++) {
+            uint32_t ref = 0xFFFFFFFFu;
+            for (size_t len = 0; len <= BIG; len++) {
+                if (len) {
+                    ref ^= buf[off + len - 1];
+                    for (int k = 0; k < 8; k++) ref = (ref >> 1) ^ (0x82F63B78u & (0u - (ref & 1)));
+                }
+                if (len <= LEN || len == BIG) {
+                    ok = ok && usr_crc32c(buf + off, len) == (ref ^ 0xFFFFFFFFu);
+                }
+            }
+        }
+        /* Chained updates over uneven pieces */
+        uint32_t c = 0;
+        for (size_t pos = 0, step = 1; pos < BIG; pos += step, step = step * 3 + 1) {
+            size_t n = pos + step > BIG ? BIG - pos : step;
+            c = usr_crc32c_update(c, buf + pos, n);
+        }
+        ok = ok && c == usr_crc32c(buf, BIG);
+        usr_cpu_disable(0);
+        if (ok) { printf("  ✅ CRC-32C %s path matches bitwise reference\n", names[p]); pass++; }
+        else    { printf("  ❌ CRC-32C %s path mismatch\n", names[p]); fail++; }
+    }
+
+    /* Combine at every split point, including empty halves */
+    int ok = usr_crc32c_combine(0x12345678u, 0, 0) == 0x12345678u;
+    uint32_t whole = usr_crc32c(buf, LEN);
+    for (size_t cut = 0; cut <= LEN; cut++) {
+        ok = ok && usr_crc32c_combine(usr_crc32c(buf, cut), usr_crc32c(buf + cut, LEN - cut),
+                                      LEN - cut) == whole;
+    }
+    if (ok) { printf("  ✅ CRC-32C combine matches the whole-buffer CRC\n"); pass++; }
+    else    { printf("  ❌ CRC-32C combine mismatch\n"); fail++; }
+    free(buf);
+}
+
+static void test_rand(void) {
+    printf("\n── Random ──\n");
+
+    uint8_t a[48], b[48], zero[48] = {0};
+    int ok = usr_rand_bytes(a, sizeof(a)) == 0 && usr_rand_bytes(b, sizeof(b)) == 0 &&
+             memcmp(a, b, sizeof(a)) != 0 && memcmp(a, zero, sizeof(a)) != 0;
+    if (ok) { printf("  ✅ usr_rand_bytes returns fresh output\n"); pass++; }
+    else    { printf("  ❌ usr_rand_bytes repeated or empty\n"); fail++; }
+
+    /* Crosses the buffer and bulk paths as well as the reseed interval */
+    size_t big_len = (1u << 20) + 12345;
+    uint8_t *big = malloc(big_len);
+    size_t counts[256] = {0};
+    ok = usr_rand_bytes(big, big_len) == 0;
+    for (size_t i = 0; i < big_len; i++) counts[big[i]]++;
+    for (int v = 0; v < 256; v++) {
+        ok = ok && counts[v] > big_len / 256 * 9 / 10 && counts[v] < big_len / 256 * 11 / 10;
+    }
+    free(big);
+    if (ok) { printf("  ✅ usr_rand_bytes bulk output is evenly spread\n"); pass++; }
+    else    { printf("  ❌ usr_rand_bytes bulk output skewed\n"); fail++; }
+
+    enum { N = 10000 };
+    uint64_t *r64 = malloc(N * sizeof(*r64));
+    uint32_t *r32 = malloc(N * sizeof(*r32));
+    int seen[7] = {0};
+    ok = usr_rand_fill_range(r64, N, 7) == 0 && usr_rand_fill_range_u32(r32, N, 7) == 0;
+    for (int i = 0; i < N; i++) {
+        ok = ok && r64[i] < 7 && r32[i] < 7;
+        if (r64[i] < 7) seen[r64[i]]++;
+        if (r32[i] < 7) seen[r32[i]]++;
+    }
+    for (int v = 0; v < 7; v++) ok = ok && seen[v] > 2 * N / 7 * 8 / 10;
+    ok = ok && usr_rand_fill_range_u32(r32, N, 0) == 0 && r32[N - 1] == 0;
+    ok = ok && usr_rand_range(1) == 0 && usr_rand_range(1000) < 1000;
+    free(r64); free(r32);
+    if (ok) { printf("  ✅ usr_rand_fill_range stays in range and covers it\n"); pass++; }
+    else    { printf("  ❌ usr_rand_fill_range out of range or skewed\n"); fail++; }
+
+#if defined(__unix__) || defined(__APPLE__)
+    /* A forked child must not replay the parent's buffered stream */
+    int fds[2];
+    uint8_t mine[32], theirs[32] = {0};
+    usr_rand_u32();
+    if (pipe(fds) == 0) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            uint8_t out[32];
+            usr_rand_bytes(out, sizeof(out));
+            ssize_t w = write(fds[1], out, sizeof(out));
+            _exit(w == (ssize_t)sizeof(out) ? 0 : 1);
+        }
+        usr_rand_bytes(mine, sizeof(mine));
+        ssize_t r = read(fds[0], theirs, sizeof(theirs));
+        waitpid(pid, NULL, 0);
+        close(fds[0]); close(fds[1]);
+        ok = pid > 0 && r == (ssize_t)sizeof(theirs) && memcmp(mine, theirs, 32) != 0;
+    } else {
+        ok = 0;
+    }
+    if (ok) { printf("  ✅ usr_rand_bytes diverges after fork()\n"); pass++; }
+    else    { printf("  ❌ usr_rand_bytes repeated output across fork()\n"); fail++; }
+#endif
 }
 
 int main(void) {
     printf("====== USR Crypto Tests ======\n");
 
+    test_sha1();
     test_sha256();
+    test_sha256_many();
     test_sha512();
+    test_sha_midstate();
     test_hmac();
+    test_hmac_sha512();
     test_pbkdf2();
+    test_pbkdf2_sha512();
+    test_pbkdf2_many();
+    test_aes_block();
     test_aes_ige();
+    test_aes_ige_stream();
+    test_aes_ige_many();
     test_aes_cbc();
+    test_aes_cbc_parallel();
+    test_aes_cbc_stream();
     test_aes_ctr();
+    test_aes_gcm();
+    test_aes_ctx();
     test_crc32();
+    test_crc32c();
+    test_rand();
 
     printf("\n══════════════════════════════\n");
     printf("Results: %d passed, %d failed\n", pass, fail);
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "usr/encoding.h"
+#include "usr/crypto.h"
 
 static int pass = 0, fail = 0;
 
@@ -51,6 +52,139 @@ static void test_base64(void) {
     check_str("base64url encode", enc, "-__-");
 }
 
+/* The SIMD paths must match the scalar code byte for byte, including
+   which inputs are rejected. USR_CPU_SSSE3 disabled = scalar only. */
+static void test_base64_simd(void) {
+    printf("\n── Base64 SIMD paths ──\n");
+
+    static const uint32_t paths[] = { 0, USR_CPU_AVX2 };
+    static const char *names[] = { "AVX2", "SSSE3" };
+    uint8_t data[256];
+    char enc[2][400], ref_enc[400];
+    uint8_t dec[2][300], ref_dec[300];
+    for (int i = 0; i < 256; i++) data[i] = (uint8_t)(i * 167 + 13);
+
+    for (size_t p = 0; p < 2; p++) {
+        /* Every length to 256, both alphabets, and back */
+        int ok = 1;
+        for (size_t len = 0; len <= 256; len++) {
+            for (int url = 0; url < 2; url++) {
+                usr_cpu_disable(USR_CPU_SSSE3);
+                size_t rn = url ? usr_base64url_encode(data, len, ref_enc)
+                                : usr_base64_encode(data, len, ref_enc);
+                usr_cpu_disable(paths[p]);
+                size_t n = url ? usr_base64url_encode(data, len, enc[p])
+                               : usr_base64_encode(data, len, enc[p]);
+                size_t d = usr_base64_decode(enc[p], n, dec[p]);
+                ok = ok && n == rn && strcmp(enc[p], ref_enc) == 0 &&
+                     d == len && memcmp(dec[p], data, len) == 0;
+            }
+        }
+        usr_cpu_disable(0);
+        if (ok) { printf("  ✅ %s encode matches scalar and round-trips\n", names[p]); pass++; }
+        else    { printf("  ❌ %s encode mismatch\n", names[p]); fail++; }
+
+        /* Every byte value at a few positions of a 96-character input:
+           same result, same error */
+        char src[97];
+        usr_base64_encode(data, 72, src);
+        static const size_t pos[] = { 0, 13, 31, 32, 50, 79, 95 };
+        ok = 1;
+        for (size_t k = 0; k < sizeof(pos) / sizeof(pos[0]); k++) {
+            for (int b = 0; b < 256; b++) {
+                char mut[96];
+                memcpy(mut, src, sizeof(mut));
+                mut[pos[k]] = (char)b;
+                usr_cpu_disable(USR_CPU_SSSE3);
+                size_t rn = usr_base64_decode(mut, sizeof(mut), ref_dec);
+                usr_cpu_disable(paths[p]);
+                size_t n = usr_base64_decode(mut, sizeof(mut), dec[p]);
+                ok = ok && n == rn && (n == (size_t)-1 || memcmp(dec[p], ref_dec, n) == 0);
+            }
+        }
+        usr_cpu_disable(0);
+        if (ok) { printf("  ✅ %s decode matches scalar for every byte value\n", names[p]); pass++; }
+        else    { printf("  ❌ %s decode differs from scalar\n", names[p]); fail++; }
+    }
+}
+
+/* Streaming contexts against the one-shot functions, over random
+   chunkings of valid, wrapped, padded, truncated and corrupted input */
+static void test_base64_stream(void) {
+    printf("\n── Base64 streaming ──\n");
+
+    enum { MAXLEN = 700, MAXENC = 1000 };
+    uint8_t data[MAXLEN], dec[MAXENC + 8], ref_dec[MAXENC + 8];
+    char src[MAXENC + 8], enc[MAXENC + 8], ref_enc[MAXENC + 8];
+    uint32_t seed = 12345;
+#define RND() (seed = seed * 1103515245u + 12345u, (seed >> 8) & 0xFFFF)
+
+    int enc_ok = 1, dec_ok = 1;
+    for (int trial = 0; trial < 3000; trial++) {
+        size_t len = RND() % MAXLEN;
+        for (size_t k = 0; k < len; k++) data[k] = (uint8_t)RND();
+        int url = trial & 1;
+
+        /* Encode in random chunks */
+        size_t rn = url ? usr_base64url_encode(data, len, ref_enc) : usr_base64_encode(data, len, ref_enc);
+        usr_base64_enc_ctx ec;
+        if (url) usr_base64url_encode_init(&ec); else usr_base64_encode_init(&ec);
+        size_t n = 0;
+        for (size_t pos = 0; pos < len; ) {
+            size_t step = 1 + RND() % (trial % 3 == 0 ? 5 : 200);
+            if (step > len - pos) step = len - pos;
+            n += usr_base64_encode_update(&ec, data + pos, step, enc + n);
+            pos += step;
+        }
+        n += usr_base64_encode_final(&ec, enc + n);
+        enc_ok = enc_ok && n == rn && strcmp(enc, ref_enc) == 0;
+
+        /* Wrap lines, then maybe corrupt or truncate */
+        size_t sl = 0;
+        for (size_t k = 0; k < rn; k++) {
+            if (k > 0 && k % 76 == 0) { src[sl++] = '\r'; src[sl++] = '\n'; }
+            src[sl++] = ref_enc[k];
+        }
+        static const char junk[] = "= \n\r!-_+/@[`{:\x80\x00";
+        if (trial % 4 == 1 && sl) {
+            size_t at = RND() % sl;
+            src[at] = junk[RND() % (sizeof(junk) - 1)];
+        }
+        if (trial % 5 == 2) sl = RND() % (sl + 1);
+
+        size_t rd = usr_base64_decode(src, sl, ref_dec);
+        usr_base64_dec_ctx dc;
+        usr_base64_decode_init(&dc);
+        size_t d = 0;
+        int err = 0;
+        for (size_t pos = 0; pos < sl && !err; ) {
+            size_t step = 1 + RND() % (trial % 3 == 0 ? 5 : 200);
+            if (step > sl - pos) step = sl - pos;
+            size_t r = usr_base64_decode_update(&dc, src + pos, step, dec + d);
+            if (r == (size_t)-1) err = 1; else d += r;
+            pos += step;
+        }
+        size_t r = usr_base64_decode_final(&dc, dec + d);
+        if (r == (size_t)-1) err = 1; else d += r;
+        if (err) dec_ok = dec_ok && rd == (size_t)-1;
+        else     dec_ok = dec_ok && rd == d && memcmp(dec, ref_dec, d) == 0;
+    }
+#undef RND
+    if (enc_ok) { printf("  ✅ chunked encode matches one-shot\n"); pass++; }
+    else        { printf("  ❌ chunked encode differs from one-shot\n"); fail++; }
+    if (dec_ok) { printf("  ✅ chunked decode matches one-shot, errors included\n"); pass++; }
+    else        { printf("  ❌ chunked decode differs from one-shot\n"); fail++; }
+
+    /* A CRLF split across chunks, and padding in the last chunk */
+    usr_base64_dec_ctx dc;
+    usr_base64_decode_init(&dc);
+    size_t d = usr_base64_decode_update(&dc, "Zm9v\r", 5, dec);
+    d += usr_base64_decode_update(&dc, "\nYm", 3, dec + d);
+    d += usr_base64_decode_update(&dc, "E=", 2, dec + d);
+    d += usr_base64_decode_final(&dc, dec + d);
+    check_bytes("decode across CRLF split", dec, d, (const uint8_t *)"fooba", 5);
+}
+
 static void test_hex(void) {
     printf("\n── Hex ──\n");
 
@@ -115,6 +249,8 @@ static void test_html_escape(void) {
 int main(void) {
     printf("====== USR Encoding Tests ======\n");
     test_base64();
+    test_base64_simd();
+    test_base64_stream();
     test_hex();
     test_url();
     test_html_escape();